@@ -9,52 +9,58 @@
 
 int AtariGo::removeRandomSuccessorsPercentage = 0;
 
-std::vector<Board> AtariGo::generateSuccessors(const Board &state) {
-    static std::vector<std::pair<int, Board> > scored_successors(BOARD_SIZE);
-    scored_successors.clear();
+void AtariGo::generateMoves(Board &state, MoveList &moveList) {
+    moveList.size = 0;
 
     const Bitboard128 occupiedBits = state.getBlackBits() | state.getWhiteBits();
     Bitboard128 successorBits = getNeighbourBits(occupiedBits);
 
+    Board::UndoRecord undo{};
     while (successorBits) {
         const int pos = popLSB(successorBits);
 
-        scored_successors.emplace_back(0, state);
-        auto &[score, successor] = scored_successors.back();
-
-        successor.setStone(pos);
-        computeHeuristic(successor);
-        score = successor.getHeuristic();
+        state.makeMove(pos, undo);
+        computeHeuristic(state);
+        moveList.moves[moveList.size++] = {pos, state.getHeuristic()};
+        state.unmakeMove(undo);
     }
 
-    if (removeRandomSuccessorsPercentage > 0 && !scored_successors.empty()) {
+    if (removeRandomSuccessorsPercentage > 0 && !moveList.empty()) {
         // Remove a percentage of successors randomly
-        const size_t initialSize = scored_successors.size();
-        size_t toRemove = static_cast<size_t>(initialSize * (removeRandomSuccessorsPercentage / 100.0));
+        const int initialSize = moveList.size;
+        int toRemove = static_cast<int>(initialSize * (removeRandomSuccessorsPercentage / 100.0));
 
         // Ensure at least one successor remains
         if (toRemove >= initialSize) toRemove = initialSize - 1;
 
         if (toRemove > 0) {
             // Shuffle the successors and then remove the specified number
-            std::shuffle(scored_successors.begin(), scored_successors.end(), getRandom());
-            scored_successors.resize(initialSize - toRemove);
+            std::shuffle(moveList.begin(), moveList.end(), getRandom());
+            moveList.size = initialSize - toRemove;
         }
     }
 
     if (state.getPlayerToMove() == BLACK) {
-        std::sort(scored_successors.begin(), scored_successors.end(),
-                  [](const auto &a, const auto &b) { return a.first < b.first; });
+        std::sort(moveList.begin(), moveList.end(),
+                  [](const auto &a, const auto &b) { return a.score < b.score; });
     } else {
-        std::sort(scored_successors.begin(), scored_successors.end(),
-                  [](const auto &a, const auto &b) { return a.first > b.first; });
+        std::sort(moveList.begin(), moveList.end(),
+                  [](const auto &a, const auto &b) { return a.score > b.score; });
     }
+}
+
+std::vector<Board> AtariGo::generateSuccessors(const Board &state) {
+    Board scratch = state;
+    MoveList moveList;
+    generateMoves(scratch, moveList);
 
     std::vector<Board> successors;
-    successors.reserve(scored_successors.size());
+    successors.reserve(moveList.size);
 
-    for (auto &[score_val, board_obj]: scored_successors) {
-        successors.push_back(std::move(board_obj));
+    for (const auto &[pos, score]: moveList) {
+        Board &successor = successors.emplace_back(state);
+        successor.setStone(pos);
+        successor.setHeuristic(score);
     }
     return successors;
 }
@@ -65,44 +71,15 @@ void AtariGo::computeLiberties(
     int &countMinB1LibGroups, int &countMinW1LibGroups,
     int &uniqueTotalBlackLib,
     int &uniqueTotalWhiteLib) {
-    // Cache bitboards
-    const Bitboard128 blackBitboard = state.getBlackBits();
-    const Bitboard128 whiteBitboard = state.getWhiteBits();
-    const Bitboard128 occupiedBits = blackBitboard | whiteBitboard;
-
     // Initialize output parameters that are summed or counted
     minBlackLib1 = minWhiteLib1 = 6;
     countMinB1LibGroups = 0;
     countMinW1LibGroups = 0;
-    uniqueTotalBlackLib = 0;
-    uniqueTotalWhiteLib = 0;
-
-    // Helper lambda to flood each color’s groups
-    auto floodColor = [&](Bitboard128 pool, const bool isBlack) {
-        // Which bitboard and accumulators to use
-        const Bitboard128 stoneBits = isBlack ? blackBitboard : whiteBitboard;
-        int &minLib1 = isBlack ? minBlackLib1 : minWhiteLib1;
-        int &countMin1 = isBlack ? countMinB1LibGroups : countMinW1LibGroups;
-
-        Bitboard128 allUniqueLibsBBForColor = 0;
-
-        while (pool) {
-            const Bitboard128 seed = static_cast<Bitboard128>(1) << popLSB(pool);
-            const Bitboard128 group = floodFillGroupBits(stoneBits, seed);
-
-            // Remove entire group from pool so we don’t revisit it
-            pool &= ~group;
-
-            // Compute liberties
-            const Bitboard128 libsBB = getLibertyBits(group, occupiedBits);
-            const int libs = bitCount(libsBB);
-
-            // If no stones, libs will be 0, skip if group is empty (should not happen if pool comes from stoneBits)
-            if (bitCount(group) == 0)
-                continue;
-
-            allUniqueLibsBBForColor |= libsBB; // Accumulate unique liberties for this color
 
+    // The board keeps every group and its liberties up to date, so this is just a scan of the live groups
+    auto scanColor = [&state](Bitboard128 slots, int &minLib1, int &countMin1) {
+        while (slots) {
+            const int libs = bitCount(state.getGroup(popLSB(slots)).liberties);
             if (libs < minLib1) {
                 minLib1 = libs;
                 countMin1 = 1;
@@ -110,16 +87,15 @@ void AtariGo::computeLiberties(
                 countMin1++;
             }
         }
-        if (isBlack) {
-            uniqueTotalBlackLib = bitCount(allUniqueLibsBBForColor);
-        } else {
-            uniqueTotalWhiteLib = bitCount(allUniqueLibsBBForColor);
-        }
     };
 
-    // Flood both colors
-    floodColor(blackBitboard, true);
-    floodColor(whiteBitboard, false);
+    scanColor(state.getGroupSlots(BLACK), minBlackLib1, countMinB1LibGroups);
+    scanColor(state.getGroupSlots(WHITE), minWhiteLib1, countMinW1LibGroups);
+
+    // The union of the liberties of all the groups of a color is the set of empty points next to that color
+    const Bitboard128 occupiedBits = state.getOccupiedBits();
+    uniqueTotalBlackLib = bitCount(getLibertyBits(state.getBlackBits(), occupiedBits));
+    uniqueTotalWhiteLib = bitCount(getLibertyBits(state.getWhiteBits(), occupiedBits));
 }
 
 void AtariGo::computeHeuristic(Board &state) {
@@ -204,30 +180,14 @@ Bitboard128 AtariGo::getCapturedGroups(Board &state) {
     if (heuristic > -WIN && heuristic < WIN)
         return 0;
 
-    const Bitboard128 capturedBitboard = heuristic >= WIN
-                                             ? state.getBlackBits()
-                                             : state.getWhiteBits();
-
-    Bitboard128 pool = capturedBitboard;
-
-    const Bitboard128 occupied = state.getBlackBits() | state.getWhiteBits();
+    Bitboard128 pool = state.getGroupSlots(heuristic >= WIN ? BLACK : WHITE);
     Bitboard128 capturedMask = 0;
 
     while (pool) {
-        const int pos = popLSB(pool);
-        const Bitboard128 seed = static_cast<Bitboard128>(1) << pos;
-
-        // flood-fill its entire group
-        const Bitboard128 group = floodFillGroupBits(capturedBitboard, seed);
-
-        // remove from pool
-        pool &= ~group;
-
-        // compute its liberties
-        const Bitboard128 libs = getLibertyBits(group, occupied);
-        if (bitCount(libs) == 0) {
+        const StoneGroup &group = state.getGroup(popLSB(pool));
+        if (!group.liberties) {
             // it's captured, accumulate it
-            capturedMask |= group;
+            capturedMask |= group.stones;
         }
     }
 
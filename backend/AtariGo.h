@@ -1,9 +1,26 @@
 #ifndef ATARIGO_H
 #define ATARIGO_H
 
+#include <array>
 #include <vector>
 #include "Board.h"
 
+// A move and the heuristic of the position it leads to
+struct ScoredMove {
+    int pos;
+    int score;
+};
+
+// Fixed-capacity move list, so generating moves never allocates
+struct MoveList {
+    std::array<ScoredMove, BOARD_SIZE> moves;
+    int size = 0;
+
+    [[nodiscard]] ScoredMove *begin() { return moves.data(); }
+    [[nodiscard]] ScoredMove *end() { return moves.data() + size; }
+    [[nodiscard]] bool empty() const { return size == 0; }
+};
+
 class AtariGo
 {
 private:
@@ -20,6 +37,10 @@ public:
 
     [[nodiscard]] static std::vector<Board> generateSuccessors(const Board &state);
 
+    // Fills `moveList` with the candidate moves of `state`, best first for the player to move, each scored with the
+    // heuristic of the resulting position. `state` is used as scratch space and is restored before returning.
+    static void generateMoves(Board &state, MoveList &moveList);
+
     [[nodiscard]] static bool isTerminal(const Board &state);
 
     // If state is terminal, returns the bitboard of the captured group; otherwise returns 0.
@@ -1,12 +1,20 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <stdexcept>
 
 #include "BBUtils.h"
 #include "Globals.h"
 
+// A chain of connected stones of one color and its liberties
+struct StoneGroup {
+    Bitboard128 stones;
+    Bitboard128 liberties;
+};
+
 class Board {
 private:
     Bitboard128 black_board;
@@ -16,6 +24,47 @@ private:
     bool isHeuristicCalculated;
     int heuristic;
 
+    // Groups are kept up to date on every stone placed, so no flood fill is needed to know them.
+    // Every stone appends one slot: the new stone merged with the own groups it touches. The groups it absorbed stay
+    // in their slots but leave the live mask of their color, which is what makes unmakeMove a matter of restoring
+    // the mask. Since stones are never removed (the game ends on the first capture), slots never run out.
+    std::array<StoneGroup, BOARD_SIZE> groups; // Only [0, groupCount) is meaningful
+    int groupCount;
+    Bitboard128 blackGroupSlots; // Bit i set if groups[i] is a live black group
+    Bitboard128 whiteGroupSlots; // Bit i set if groups[i] is a live white group
+
+    // Adds the stone (already on the bitboards) to the group table. Reports the own live groups before the merge and
+    // the opponent groups that lost the liberty, which is all unmakeMove needs to undo it.
+    void addToGroups(const Bitboard128 stone, const bool black, Bitboard128 &ownSlotsBefore,
+                     Bitboard128 &touchedOpponentSlots) {
+        Bitboard128 &ownSlots = black ? blackGroupSlots : whiteGroupSlots;
+        ownSlotsBefore = ownSlots;
+        touchedOpponentSlots = 0;
+
+        // A liberty of a group is adjacent to it, so the groups that have the stone as a liberty are its neighbours
+        Bitboard128 mergedStones = stone;
+        Bitboard128 slots = ownSlots;
+        while (slots) {
+            const int slot = popLSB(slots);
+            if (groups[slot].liberties & stone) {
+                mergedStones |= groups[slot].stones;
+                clearBit(ownSlots, slot);
+            }
+        }
+
+        slots = black ? whiteGroupSlots : blackGroupSlots;
+        while (slots) {
+            const int slot = popLSB(slots);
+            if (groups[slot].liberties & stone) {
+                groups[slot].liberties &= ~stone;
+                setBit(touchedOpponentSlots, slot);
+            }
+        }
+
+        groups[groupCount] = {mergedStones, getLibertyBits(mergedStones, black_board | white_board)};
+        setBit(ownSlots, groupCount++);
+    }
+
     // Convert (row, col) into a single bit‐index: row-major, 0 ≤ row,col < BOARD_EDGE
     static constexpr int pos_from_coord(const int row, const int col) {
         // constexpr
@@ -23,7 +72,43 @@ private:
     }
 
 public:
-    Board() : black_board(0), white_board(0), zobrist_hash(0), turn(1), isHeuristicCalculated(false), heuristic(0) {
+    // Everything makeMove changes, so unmakeMove can restore the previous position without copying the Board
+    struct UndoRecord {
+        Bitboard128 stoneDelta; // Bit of the stone that was placed
+        uint64_t hashDelta; // Zobrist value XOR-ed into the signature
+        int heuristic;
+        bool wasBlack;
+        bool isHeuristicCalculated;
+        Bitboard128 ownGroupSlots; // Live group mask of the mover's color before the move
+        Bitboard128 touchedOpponentGroupSlots; // Opponent groups that lost the liberty
+    };
+
+    Board() : black_board(0), white_board(0), zobrist_hash(0), turn(1), isHeuristicCalculated(false), heuristic(0),
+              groupCount(0), blackGroupSlots(0), whiteGroupSlots(0) {
+    }
+
+    // Copies only the used part of the group table
+    Board(const Board &other) : black_board(other.black_board), white_board(other.white_board),
+                                zobrist_hash(other.zobrist_hash), turn(other.turn),
+                                isHeuristicCalculated(other.isHeuristicCalculated), heuristic(other.heuristic),
+                                groupCount(other.groupCount), blackGroupSlots(other.blackGroupSlots),
+                                whiteGroupSlots(other.whiteGroupSlots) {
+        std::copy_n(other.groups.begin(), groupCount, groups.begin());
+    }
+
+    Board &operator=(const Board &other) {
+        if (this == &other) return *this;
+        black_board = other.black_board;
+        white_board = other.white_board;
+        zobrist_hash = other.zobrist_hash;
+        turn = other.turn;
+        isHeuristicCalculated = other.isHeuristicCalculated;
+        heuristic = other.heuristic;
+        groupCount = other.groupCount;
+        blackGroupSlots = other.blackGroupSlots;
+        whiteGroupSlots = other.whiteGroupSlots;
+        std::copy_n(other.groups.begin(), groupCount, groups.begin());
+        return *this;
     }
 
     void setHeuristic(const int h) {
@@ -72,6 +157,8 @@ public:
         if (!isEmpty(pos))
             throw std::runtime_error("Position already occupied.");
         setBit(black_board, pos);
+        Bitboard128 ownSlotsBefore, touchedOpponentSlots;
+        addToGroups(ONE_BIT << pos, true, ownSlotsBefore, touchedOpponentSlots);
         // XOR the Zobrist hash with the precomputed random value for Black on square `pos`
         zobrist_hash ^= ZOBRIST_TABLE[0][pos];
         ++turn;
@@ -82,12 +169,56 @@ public:
         if (!isEmpty(pos))
             throw std::runtime_error("Position already occupied.");
         setBit(white_board, pos);
+        Bitboard128 ownSlotsBefore, touchedOpponentSlots;
+        addToGroups(ONE_BIT << pos, false, ownSlotsBefore, touchedOpponentSlots);
         // XOR the Zobrist hash with the precomputed random value for White on square `pos`
         zobrist_hash ^= ZOBRIST_TABLE[1][pos];
         ++turn;
         isHeuristicCalculated = false;
     }
 
+    /// Places a stone for the player to move, without the occupancy check of setStone, and records how to undo it.
+    /// The move must be on an empty point.
+    void makeMove(const int pos, UndoRecord &undo) {
+        const bool black = getPlayerToMove() == BLACK;
+        undo.stoneDelta = ONE_BIT << pos;
+        undo.hashDelta = ZOBRIST_TABLE[black ? 0 : 1][pos];
+        undo.heuristic = heuristic;
+        undo.wasBlack = black;
+        undo.isHeuristicCalculated = isHeuristicCalculated;
+
+        (black ? black_board : white_board) |= undo.stoneDelta;
+        addToGroups(undo.stoneDelta, black, undo.ownGroupSlots, undo.touchedOpponentGroupSlots);
+        zobrist_hash ^= undo.hashDelta;
+        ++turn;
+        isHeuristicCalculated = false;
+    }
+
+    /// Reverts the makeMove that produced `undo`. Moves must be unmade in the reverse order they were made.
+    void unmakeMove(const UndoRecord &undo) {
+        (undo.wasBlack ? black_board : white_board) ^= undo.stoneDelta;
+        --groupCount;
+        (undo.wasBlack ? blackGroupSlots : whiteGroupSlots) = undo.ownGroupSlots;
+        Bitboard128 touched = undo.touchedOpponentGroupSlots;
+        while (touched) groups[popLSB(touched)].liberties |= undo.stoneDelta;
+        zobrist_hash ^= undo.hashDelta;
+        --turn;
+        heuristic = undo.heuristic;
+        isHeuristicCalculated = undo.isHeuristicCalculated;
+    }
+
+    /// Passes the turn without placing a stone, for searches that ask what a player could do if the opponent did
+    /// nothing. The signature does not change, so such positions must not go to the transposition table.
+    void makeNullMove() {
+        ++turn;
+        isHeuristicCalculated = false;
+    }
+
+    void unmakeNullMove() {
+        --turn;
+        isHeuristicCalculated = false;
+    }
+
     [[nodiscard]] bool getIsHeuristicCalculated() const { return isHeuristicCalculated; }
 
     [[nodiscard]] int getHeuristic() const {
@@ -100,6 +231,23 @@ public:
     [[nodiscard]] Bitboard128 getBlackBits() const { return black_board; }
     [[nodiscard]] Bitboard128 getWhiteBits() const { return white_board; }
     [[nodiscard]] Bitboard128 getOccupiedBits() const { return black_board | white_board; }
+
+    /// Slot mask of the live groups of `player`, to be iterated with popLSB and read with getGroup.
+    [[nodiscard]] Bitboard128 getGroupSlots(const Player player) const {
+        return player == BLACK ? blackGroupSlots : whiteGroupSlots;
+    }
+
+    [[nodiscard]] const StoneGroup &getGroup(const int slot) const { return groups[slot]; }
+
+    /// The live group containing the stone at `pos`. The point must not be empty.
+    [[nodiscard]] const StoneGroup &getGroupAt(const int pos) const {
+        Bitboard128 slots = isBlack(pos) ? blackGroupSlots : whiteGroupSlots;
+        while (slots) {
+            const int slot = popLSB(slots);
+            if (testBit(groups[slot].stones, pos)) return groups[slot];
+        }
+        throw std::runtime_error("No stone at position.");
+    }
 };
 
 #endif
@@ -0,0 +1,266 @@
+#ifndef DFPNSOLVER_H
+#define DFPNSOLVER_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "BBUtils.h"
+#include "Board.h"
+
+#ifdef __EMSCRIPTEN__
+constexpr size_t DEFAULT_DFPN_TT_SIZE_MB = 8;
+#else
+constexpr size_t DEFAULT_DFPN_TT_SIZE_MB = 32;
+#endif
+
+/// Depth-first proof-number search (df-pn), which decides positions exactly: whether the player to move wins, no
+/// matter how long the game takes. It has no depth horizon. Instead it spends its work where the proof or disproof
+/// looks cheapest, going by proof and disproof numbers kept in its own table.
+///
+/// Every game of Atari Go ends with a capture, so a position not won by the player to move is lost.
+/// The solver applies two rules: capturing wins at once, and a player with a group in atari must extend at its last
+/// liberty. The numbers use the phi/delta form: phi is the proof number for the player to move, delta the disproof.
+class DfpnSolver {
+public:
+    enum Outcome { UNKNOWN, MOVER_WINS, MOVER_LOSES };
+
+private:
+    static constexpr uint32_t INFINITE = 1u << 30;
+
+    // 16 bytes. A zero key marks an empty slot; a real zero signature is just never cached.
+    struct Entry {
+        uint64_t key;
+        uint32_t phi;
+        uint32_t delta;
+    };
+
+    static constexpr int BUCKET_ENTRIES = 4;
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_ENTRIES];
+    };
+
+    static_assert(sizeof(Bucket) == 64, "A df-pn bucket must be exactly one cache line");
+
+    std::unique_ptr<Bucket[]> buckets;
+    uint64_t bucketMask = 0;
+
+    Board board;
+    std::array<Board::UndoRecord, BOARD_SIZE> undoStack{};
+    int ply = 0;
+
+    uint64_t nodeCount = 0;
+    uint64_t nodeLimit = 0;
+    std::chrono::steady_clock::time_point deadline;
+    bool aborted = false;
+
+    static uint32_t addSaturated(const uint32_t a, const uint32_t b) { return std::min(INFINITE, a + b); }
+
+    // Key 0 marks an empty slot, so it is never stored: the empty board, whose signature is 0, always reads as unknown
+    void lookup(const uint64_t key, uint32_t &phi, uint32_t &delta) const {
+        if (key) {
+            for (const Entry &e: buckets[key & bucketMask].entries) {
+                if (e.key == key) {
+                    phi = e.phi;
+                    delta = e.delta;
+                    return;
+                }
+            }
+        }
+        phi = delta = 1;
+    }
+
+    // Same position first, then an empty slot, then the unresolved entry with the least work behind it. Resolved
+    // entries are final and only go when nothing else is left.
+    void store(const uint64_t key, const uint32_t phi, const uint32_t delta) {
+        if (!key) return;
+        Bucket &bucket = buckets[key & bucketMask];
+        Entry *victim = nullptr;
+        auto worth = [](const Entry &e) -> uint64_t {
+            if (!e.phi || !e.delta) return UINT64_MAX;
+            return static_cast<uint64_t>(e.phi) + e.delta;
+        };
+        for (Entry &e: bucket.entries) {
+            if (e.key == key || !e.key) {
+                victim = &e;
+                break;
+            }
+            if (!victim || worth(e) < worth(*victim)) victim = &e;
+        }
+        *victim = {key, phi, delta};
+    }
+
+    // The moves worth looking at, or 0 if the player to move wins at once (sets `moverWins`)
+    Bitboard128 generateMoves(bool &moverWins) const {
+        const Player toMove = board.getPlayerToMove();
+        const Player opponent = toMove == BLACK ? WHITE : BLACK;
+        moverWins = false;
+
+        for (Bitboard128 slots = board.getGroupSlots(opponent); slots;) {
+            if (bitCount(board.getGroup(popLSB(slots)).liberties) == 1) {
+                moverWins = true;
+                return 0;
+            }
+        }
+
+        // A group in atari must be saved, and with nothing to capture the only way is to extend at its liberty
+        Bitboard128 escapes = 0;
+        bool inAtari = false;
+        for (Bitboard128 slots = board.getGroupSlots(toMove); slots;) {
+            const Bitboard128 libs = board.getGroup(popLSB(slots)).liberties;
+            if (bitCount(libs) == 1) {
+                escapes = inAtari ? escapes & libs : libs; // Two groups in atari: only a shared liberty saves both
+                inAtari = true;
+            }
+        }
+        if (inAtari) return escapes;
+        return ~board.getOccupiedBits() & FULL_BOARD_MASK;
+    }
+
+    // A move is known by the signature of the position it leads to, or by 0 if it is suicide: a move that leaves one
+    // of the mover's groups without liberties loses at once
+    uint64_t childKey(const int pos) {
+        board.makeMove(pos, undoStack[ply]);
+        const Player mover = board.getPlayerToMove() == BLACK ? WHITE : BLACK;
+        uint64_t key = board.getSignature();
+        for (Bitboard128 slots = board.getGroupSlots(mover); slots;) {
+            if (!board.getGroup(popLSB(slots)).liberties) key = 0;
+        }
+        board.unmakeMove(undoStack[ply]);
+        return key;
+    }
+
+    // Phi and delta of a child, seen from the player to move there
+    void childNumbers(const uint64_t key, uint32_t &phi, uint32_t &delta) const {
+        if (!key) {
+            phi = 0;
+            delta = INFINITE;
+        } else {
+            lookup(key, phi, delta);
+        }
+    }
+
+    bool outOfResources() {
+        if (aborted) return true;
+        if (nodeCount >= nodeLimit || ((nodeCount & 1023) == 0 && std::chrono::steady_clock::now() >= deadline))
+            aborted = true;
+        return aborted;
+    }
+
+    // Expands the current position until its phi reaches thPhi or its delta reaches thDelta
+    void multipleIterativeDeepening(uint32_t thPhi, uint32_t thDelta) {
+        ++nodeCount;
+        const uint64_t key = board.getSignature();
+
+        bool moverWins;
+        const Bitboard128 moves = generateMoves(moverWins);
+        if (moverWins || !moves) {
+            // No move saves the group in atari: the opponent captures next
+            if (moverWins) store(key, 0, INFINITE);
+            else store(key, INFINITE, 0);
+            return;
+        }
+
+        std::array<int, BOARD_SIZE> children{};
+        std::array<uint64_t, BOARD_SIZE> childKeys{};
+        int childCount = 0;
+        for (Bitboard128 bits = moves; bits; ++childCount) {
+            children[childCount] = popLSB(bits);
+            childKeys[childCount] = childKey(children[childCount]);
+        }
+
+        while (true) {
+            // phi(n) = min delta(child), delta(n) = sum phi(child); track the two smallest child deltas
+            uint32_t phi = INFINITE, delta = 0, secondBestDelta = INFINITE;
+            uint32_t bestChildPhi = 0;
+            int bestChild = NO_MOVE;
+            for (int i = 0; i < childCount; ++i) {
+                uint32_t childPhi, childDelta;
+                childNumbers(childKeys[i], childPhi, childDelta);
+                delta = addSaturated(delta, childPhi);
+                if (childDelta < phi) {
+                    secondBestDelta = phi;
+                    phi = childDelta;
+                    bestChild = children[i];
+                    bestChildPhi = childPhi;
+                } else if (childDelta < secondBestDelta) {
+                    secondBestDelta = childDelta;
+                }
+            }
+
+            if (phi >= thPhi || delta >= thDelta || outOfResources()) {
+                store(key, phi, delta);
+                return;
+            }
+
+            board.makeMove(bestChild, undoStack[ply++]);
+            multipleIterativeDeepening(addSaturated(thDelta - delta, bestChildPhi),
+                                       std::min(thPhi, addSaturated(secondBestDelta, 1)));
+            board.unmakeMove(undoStack[--ply]);
+        }
+    }
+
+public:
+    explicit DfpnSolver(const size_t megabytes = DEFAULT_DFPN_TT_SIZE_MB) {
+        const size_t bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= bytes) count *= 2;
+        buckets = std::make_unique<Bucket[]>(count);
+        bucketMask = count - 1;
+        clear();
+    }
+
+    /// Proof and disproof numbers stay valid from one position to the next, so the table is only cleared on demand.
+    void clear() {
+        for (uint64_t i = 0; i <= bucketMask; ++i) {
+            for (Entry &e: buckets[i].entries) e = {0, 0, 0};
+        }
+    }
+
+    /// Tries to decide `state` within `maxNodes` expansions and `timeLimit`. UNKNOWN means the limits ran out first.
+    Outcome solve(const Board &state, const uint64_t maxNodes, const std::chrono::milliseconds timeLimit) {
+        board = state;
+        ply = 0;
+        nodeCount = 0;
+        nodeLimit = maxNodes;
+        deadline = std::chrono::steady_clock::now() + timeLimit;
+        aborted = false;
+
+        multipleIterativeDeepening(INFINITE - 1, INFINITE - 1);
+
+        uint32_t phi, delta;
+        lookup(board.getSignature(), phi, delta);
+        if (phi == 0) return MOVER_WINS;
+        if (delta == 0) return MOVER_LOSES;
+        return UNKNOWN;
+    }
+
+    /// After solve returned MOVER_WINS for `state`: a move that keeps the win, or NO_MOVE if it is no longer cached.
+    [[nodiscard]] int winningMove(const Board &state) {
+        board = state;
+        ply = 0;
+        bool moverWins;
+        const Bitboard128 moves = generateMoves(moverWins);
+        if (moverWins) {
+            const Player opponent = board.getPlayerToMove() == BLACK ? WHITE : BLACK;
+            for (Bitboard128 slots = board.getGroupSlots(opponent); slots;) {
+                const Bitboard128 libs = board.getGroup(popLSB(slots)).liberties;
+                if (bitCount(libs) == 1) return getLSBIndex(libs);
+            }
+        }
+        for (Bitboard128 bits = moves; bits;) {
+            const int pos = popLSB(bits);
+            uint32_t phi, delta;
+            childNumbers(childKey(pos), phi, delta);
+            if (delta == 0) return pos;
+        }
+        return NO_MOVE;
+    }
+
+    [[nodiscard]] uint64_t getNodeCount() const { return nodeCount; }
+};
+
+#endif
@@ -14,6 +14,7 @@ constexpr int BOARD_EDGE = 9;
 #endif
 
 constexpr int BOARD_SIZE = BOARD_EDGE * BOARD_EDGE;
+constexpr int NO_MOVE = -1;
 constexpr int WIN = 100'000'000;
 constexpr int  ATARI_THREAT_SCORE = 1'000'000;
 constexpr int  MIN_LIB_MULTIPLIER = 2'000;
@@ -48,7 +49,8 @@ constexpr std::array<std::array<uint64_t, BOARD_SIZE>, 2> generateZobristTable()
 inline constexpr auto ZOBRIST_TABLE = generateZobristTable();
 
 inline std::mt19937& getRandom() {
-    static std::mt19937 engine(std::random_device{}());
+    // One engine per thread, so the search threads never share generator state
+    thread_local std::mt19937 engine(std::random_device{}());
     return engine;
 }
 
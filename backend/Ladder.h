@@ -0,0 +1,126 @@
+#ifndef LADDER_H
+#define LADDER_H
+
+#include "BBUtils.h"
+#include "Board.h"
+
+/// Ladder reader. A ladder is the chase of a group with two liberties: the attacker ataris it, the defender extends at
+/// the last liberty, and so on until the group is captured or reaches three liberties. In Atari Go the defender of a
+/// group in atari has only two sensible replies, extending or capturing an attacking group in atari (anything else
+/// loses the group, and the game), so the chase can be read by following those moves only, on the raw bitboards.
+///
+/// A ladder read as working is a forced win for the attacker. The reader is conservative: it ignores the side wins of
+/// the chase (e.g. the atari also capturing another group), so a ladder read as failing may still work.
+class Ladder {
+public:
+    struct Result {
+        bool captured = false;
+        int firstMove = NO_MOVE; // Atari that starts the ladder, NO_MOVE if the prey is already in atari
+        int plies = 0; // Length of the chase, capture included
+    };
+
+private:
+    // Bounds the attacker moves tried by one read: when both ataris keep the prey at two liberties the chase branches
+    static constexpr int NODE_BUDGET = 512;
+
+    // Any attacker group next to the prey has at most one liberty: the defender would capture it instead of extending
+    static bool attackerNextToPreyInAtari(const Bitboard128 attacker, const Bitboard128 prey,
+                                          const Bitboard128 occupied) {
+        Bitboard128 adjacent = getNeighbourBits(prey) & attacker;
+        while (adjacent) {
+            const Bitboard128 group = floodFillGroupBits(attacker, adjacent & -adjacent);
+            if (bitCount(getLibertyBits(group, occupied)) <= 1) return true;
+            adjacent &= ~group;
+        }
+        return false;
+    }
+
+    // Attacker to move, prey with two liberties. Returns the plies to the capture, or 0 if the prey escapes.
+    static int chase(const Bitboard128 attacker, const Bitboard128 defender, const Bitboard128 prey,
+                     const Bitboard128 liberties, int &budget, int &firstMove) {
+        for (Bitboard128 atariMoves = liberties; atariMoves;) {
+            if (--budget < 0) return 0;
+            const Bitboard128 atari = atariMoves & -atariMoves;
+            atariMoves ^= atari;
+            const Bitboard128 extension = liberties & ~atari;
+
+            const Bitboard128 chaser = attacker | atari;
+            if (attackerNextToPreyInAtari(chaser, prey, chaser | defender)) continue;
+
+            // The defender extends at its last liberty
+            const Bitboard128 runner = defender | extension;
+            const Bitboard128 occupied = chaser | runner;
+            const Bitboard128 extended = floodFillGroupBits(runner, prey | extension);
+            const Bitboard128 newLiberties = getLibertyBits(extended, occupied);
+
+            int plies = 0;
+            switch (bitCount(newLiberties)) {
+                case 1: plies = 3; break; // Atari, extension, capture
+                case 2: {
+                    if (attackerNextToPreyInAtari(chaser, extended, occupied)) break;
+                    int ignored;
+                    if (const int rest = chase(chaser, runner, extended, newLiberties, budget, ignored)) plies = 2 + rest;
+                    break;
+                }
+                default: break; // Escaped
+            }
+            if (plies) {
+                firstMove = getLSBIndex(atari);
+                return plies;
+            }
+        }
+        return 0;
+    }
+
+public:
+    /// Reads the ladder against the group containing `preyStone`, the attacker to move. `attacker` and `defender` are
+    /// the stones of each side. The attacker must not have a group in atari (see findCapture).
+    [[nodiscard]] static Result read(const Bitboard128 attacker, const Bitboard128 defender,
+                                     const Bitboard128 preyStone) {
+        Result result;
+        const Bitboard128 occupied = attacker | defender;
+        const Bitboard128 prey = floodFillGroupBits(defender, preyStone);
+        const Bitboard128 liberties = getLibertyBits(prey, occupied);
+
+        switch (bitCount(liberties)) {
+            case 0: break;
+            case 1:
+                result.captured = true;
+                result.plies = 1;
+                break;
+            case 2: {
+                if (attackerNextToPreyInAtari(attacker, prey, occupied)) break;
+                int budget = NODE_BUDGET;
+                result.plies = chase(attacker, defender, prey, liberties, budget, result.firstMove);
+                result.captured = result.plies > 0;
+                break;
+            }
+            default: break;
+        }
+        return result;
+    }
+
+    /// Looks for an opponent group the player to move captures in a ladder, the shortest one if there are several.
+    /// Positions where the player to move has a group in atari are not read: the opponent would capture first.
+    [[nodiscard]] static Result findCapture(const Board &state) {
+        const Player toMove = state.getPlayerToMove();
+        const Player opponent = toMove == BLACK ? WHITE : BLACK;
+
+        for (Bitboard128 slots = state.getGroupSlots(toMove); slots;) {
+            if (bitCount(state.getGroup(popLSB(slots)).liberties) <= 1) return {};
+        }
+
+        const Bitboard128 attacker = toMove == BLACK ? state.getBlackBits() : state.getWhiteBits();
+        const Bitboard128 defender = toMove == BLACK ? state.getWhiteBits() : state.getBlackBits();
+        Result best;
+        for (Bitboard128 slots = state.getGroupSlots(opponent); slots;) {
+            const StoneGroup &group = state.getGroup(popLSB(slots));
+            if (bitCount(group.liberties) > 2) continue;
+            const Result result = read(attacker, defender, group.stones);
+            if (result.captured && (!best.captured || result.plies < best.plies)) best = result;
+        }
+        return best;
+    }
+};
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef LAMBDASEARCH_H
+#define LAMBDASEARCH_H
+
+#include <array>
+#include <cstdint>
+
+#include "BBUtils.h"
+#include "Board.h"
+
+/// Lambda search (threat-space search) for forced captures.
+/// A lambda tree of order n only contains attacker moves that threaten to win with a tree of order n - 1 if the
+/// defender passed, and defender moves that stop that threat. Order 0 is an immediate capture, so at order 1 the
+/// attacker only plays ataris, at order 2 it plays threats of ataris that win, and so on. Defender moves are tried on
+/// every empty point (a stone far away can still break a ladder), but a reply that leaves the lower-order threat in
+/// place is refuted by the cheap lower-order search instead of a full one.
+///
+/// The search only proves wins: a move it returns wins by force against any defence, while NO_MOVE means that no
+/// proof was found within the limits, not that there is none.
+class LambdaSearch {
+private:
+    const int maxOrder;
+    const int maxDepth; // Attacker moves in the main line
+    const uint64_t nodeBudget;
+
+    Board board;
+    std::array<Board::UndoRecord, BOARD_SIZE> undoStack{};
+    int stonesPlaced = 0; // Index of the next free undo record, null moves do not use one
+    uint64_t nodeCount = 0;
+
+    // The player to move captures with their next stone: some opponent group has a single liberty
+    [[nodiscard]] bool canCaptureNow() const {
+        const Player toMove = board.getPlayerToMove();
+        for (Bitboard128 slots = board.getGroupSlots(toMove == BLACK ? WHITE : BLACK); slots;) {
+            if (bitCount(board.getGroup(popLSB(slots)).liberties) == 1) return true;
+        }
+        return false;
+    }
+
+    // Result of the move just played, from the point of view of the player who played it: 1 if it captured, -1 if it
+    // was suicide, 0 otherwise. A move that captures wins even if its own group has no liberties left.
+    [[nodiscard]] int lastMoveOutcome() const {
+        const Player mover = board.getPlayerToMove() == BLACK ? WHITE : BLACK;
+        const Player other = mover == BLACK ? WHITE : BLACK;
+        for (Bitboard128 slots = board.getGroupSlots(other); slots;) {
+            if (!board.getGroup(popLSB(slots)).liberties) return 1;
+        }
+        for (Bitboard128 slots = board.getGroupSlots(mover); slots;) {
+            if (!board.getGroup(popLSB(slots)).liberties) return -1;
+        }
+        return 0;
+    }
+
+    void play(const int pos) { board.makeMove(pos, undoStack[stonesPlaced++]); }
+    void undo() { board.unmakeMove(undoStack[--stonesPlaced]); }
+
+    [[nodiscard]] bool outOfBudget() const { return nodeCount >= nodeBudget; }
+
+    // Attacker to move: can it win with a tree of order `order` and at most `depth` more attacker moves?
+    bool attack(const int order, const int depth, int *winningMove = nullptr) {
+        ++nodeCount;
+        if (canCaptureNow()) {
+            if (winningMove) {
+                // Pick the capturing point, for the root
+                const Player toMove = board.getPlayerToMove();
+                for (Bitboard128 slots = board.getGroupSlots(toMove == BLACK ? WHITE : BLACK); slots;) {
+                    const Bitboard128 libs = board.getGroup(popLSB(slots)).liberties;
+                    if (bitCount(libs) == 1) *winningMove = getLSBIndex(libs);
+                }
+            }
+            return true;
+        }
+        if (order == 0 || depth == 0 || outOfBudget()) return false;
+
+        // A move can only threaten something if it touches a group
+        for (Bitboard128 moves = getNeighbourBits(board.getOccupiedBits()); moves && !outOfBudget();) {
+            const int pos = popLSB(moves);
+            play(pos);
+            bool won = false;
+            if (lastMoveOutcome() == 0) {
+                // Threat test: with the defender passing, the attacker must win with a lower order
+                board.makeNullMove();
+                const bool threat = attack(order - 1, depth - 1);
+                board.unmakeNullMove();
+                won = threat && defend(order, depth);
+            }
+            undo();
+            if (won) {
+                if (winningMove) *winningMove = pos;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Defender to move, facing a threat of order `order - 1`: does the attacker still win against every reply?
+    bool defend(const int order, const int depth) {
+        ++nodeCount;
+        if (canCaptureNow()) return false;
+
+        for (Bitboard128 moves = ~board.getOccupiedBits() & FULL_BOARD_MASK; moves;) {
+            if (outOfBudget()) return false;
+            const int pos = popLSB(moves);
+            play(pos);
+            const int outcome = lastMoveOutcome();
+            // A reply that leaves the threat in place loses to the lower order, which is cheaper to prove
+            const bool refuted = outcome == -1
+                                 || (outcome == 0 && (attack(order - 1, depth - 1) || attack(order, depth - 1)));
+            undo();
+            if (!refuted) return false;
+        }
+        return true;
+    }
+
+public:
+    LambdaSearch(const Board &state, const int maxOrder, const int maxDepth, const uint64_t nodeBudget)
+        : maxOrder(maxOrder), maxDepth(maxDepth), nodeBudget(nodeBudget), board(state) {
+    }
+
+    /// Looks for a forced capture for the player to move, shortest and lowest order first. Returns its first move, or
+    /// NO_MOVE if none was proved before the node budget ran out.
+    int findWin() {
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            for (int order = 1; order <= maxOrder; ++order) {
+                int move = NO_MOVE;
+                if (attack(order, depth, &move)) return move;
+                if (outOfBudget()) return NO_MOVE;
+            }
+        }
+        return NO_MOVE;
+    }
+
+    [[nodiscard]] uint64_t getNodeCount() const { return nodeCount; }
+};
+
+#endif
@@ -1,13 +1,36 @@
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
 #include <chrono>
-#include "unordered_dense.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include "AtariGo.h"
+#include "DfpnSolver.h"
+#include "Ladder.h"
+#include "LambdaSearch.h"
+#include "MovePicker.h"
+#include "ProbCut.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
 
 
 inline Player opponent(const Player p) { return p == BLACK ? WHITE : BLACK; }
 constexpr int INF = WIN * 2;
 constexpr uint64_t CHECK_INTERVAL = 10'000;
+// Aspiration windows: initial half-width around the previous score, and the size past which the window is dropped
+constexpr int ASPIRATION_DELTA = MIN_LIB_MULTIPLIER / 4;
+constexpr int ASPIRATION_MAX_DELTA = ATARI_THREAT_SCORE;
+// Atari extensions are counted in 1/EXTENSION_PLY of a ply
+constexpr int EXTENSION_PLY = 16;
+// MTD(f) passes per depth before giving up on convergence and searching with a full window
+constexpr int MTDF_MAX_PASSES = 32;
+// Every ply places a stone, so no line can be longer than the board
+constexpr int MAX_PLY = BOARD_SIZE;
 
 inline int distanceAwareScore(const int raw, const int ply) {
     if (raw >= WIN) return raw - ply; // sooner win  -> bigger value
@@ -15,36 +38,285 @@ inline int distanceAwareScore(const int raw, const int ply) {
     return raw; // heuristic, leave untouched
 }
 
+struct SearchOptions {
+    // Lazy SMP: threads searching the same root over the shared TT, including the calling thread
+    int threads = 1;
+    size_t ttSizeMb = DEFAULT_TT_SIZE_MB;
+    // Principal Variation Search: siblings after the first get a zero-width window and are re-searched only if
+    // they beat it. When false, every sibling is searched with the full (alpha, beta) window.
+    bool principalVariationSearch = false;
+    // Search each iteration inside a window around the previous iteration's score, widening it on failure
+    bool aspirationWindows = true;
+    // Stop between iterations when the next depth is unlikely to finish or the best move is settled (see
+    // TimeManager). When false, the search runs until the time limit and loses the unfinished iteration.
+    bool timeManagement = true;
+    // Past the nominal depth, keep playing captures and atari escapes until the position is quiet
+    bool quiescence = true;
+    // Read ladders at every node: a working ladder for the player to move is a forced win, scored without searching
+    bool ladders = true;
+    // Lambda search run before the alpha-beta search: a forced capture it proves is played at once. Order 0 disables
+    // it. The depth counts attacker moves; the node budget bounds the time lost when there is nothing to prove.
+    int lambdaOrder = 2;
+    int lambdaDepth = 6;
+    uint64_t lambdaNodeBudget = 100'000;
+    // Df-pn proof of the root, tried after the lambda search with at most this many nodes and a tenth of the time
+    // limit. 0 disables it. Its table keeps the proofs from one move to the next.
+    uint64_t dfpnNodeBudget = 20'000;
+    size_t dfpnTtSizeMb = DEFAULT_DFPN_TT_SIZE_MB;
+    // Late move reductions: past the first lmrFullDepthMoves moves, quiet moves at depth lmrMinDepth or more are first
+    // searched lmrBase + ln(depth) * ln(move number) / lmrDivisor plies shallower with a zero window, and searched
+    // again at full depth only if they beat the best move so far
+    bool lateMoveReductions = true;
+    int lmrFullDepthMoves = 3;
+    int lmrMinDepth = 3;
+    double lmrBase = 0.5;
+    double lmrDivisor = 2.0;
+    // Root driver: MTD(f), a sequence of zero-window searches converging on the score, instead of the aspiration
+    // window search. Both use the same minimax and transposition table.
+    bool mtdf = false;
+    // ProbCut (see ProbCut.h): prune a node when a search ProbCut::REDUCTION plies shallower predicts a score more
+    // than probCutThreshold standard deviations outside the window. Off by default: with the calibrated models, the bench
+    // search needed more nodes from depth 16 on than without it
+    bool probCut = false;
+    double probCutThreshold = 1.5;
+    // Enhanced transposition cutoffs: before searching any child, probe the table for every child and cut if one of
+    // them is already known to refute the window. Only from etcMinDepth up, where a saved subtree outweighs the probes.
+    bool enhancedTranspositionCutoffs = true;
+    int etcMinDepth = 4;
+    // Atari extensions, in fractions of a ply: a move that puts an opponent group in atari adds atariExtension, one that
+    // gets an own group out of atari adds escapeExtension. The fractions add up along the line and every whole ply
+    // they reach deepens the search by one, up to maxExtensionPlies per line.
+    bool atariExtensions = true;
+    double atariExtension = 0.5;
+    double escapeExtension = 0.75;
+    int maxExtensionPlies = 4;
+};
+
+// Snapshot of a running search, see SearchHandle::poll
+struct SearchProgress {
+    int depth = 0; // Last completed depth, 0 before the first one completes
+    int score = 0; // Best score of that depth
+    int bestMove = NO_MOVE; // Best move of that depth
+    uint64_t nodeCount = 0; // Nodes searched so far by all threads, updated every CHECK_INTERVAL nodes
+    bool finished = false;
+};
+
+/// One root move of a multi-PV search (see MiniMax::getTopMoves)
+struct RootLine {
+    int move = NO_MOVE;
+    int score = 0; // Exact score of the move at `depth`, White positive as everywhere else
+    int depth = 0; // Depth the score was searched to
+    std::vector<int> pv; // Principal variation read from the transposition table, starting with `move`
+};
+
+class SearchHandle;
 
 class MiniMax {
+public:
+    /// Lets another thread steer a running getBestMove (stop it, or hold its clock while it ponders) and follow its
+    /// progress.
+    struct SearchControl {
+        std::atomic<bool> stop{false};
+        // While set, the time limit is not enforced and nothing is logged. Clearing it makes the limit count from the
+        // start of the search, so a search that pondered on the move actually played has already used its budget.
+        std::atomic<bool> pondering{false};
+
+        // Written by the search
+        std::atomic<uint64_t> nodeCount{0};
+        mutable std::mutex progressMutex; // Guards the fields below, updated once per completed depth
+        int completedDepth = 0;
+        int score = 0;
+        int bestMove = NO_MOVE;
+    };
+
 private:
-    // Transposition table: signature -> (score, depth, bound)
-    mutable ankerl::unordered_dense::map<uint64_t, std::tuple<int, int, Bound> > transpositionTable;
+    // Transposition table: signature -> (score, depth, bound, move), fixed size and shared by all search threads
+    // It persists across getBestMove calls: the next position is usually two plies deeper in the same tree.
+    mutable TranspositionTable transpositionTable;
+    SearchOptions options;
+    // Handicap the TT entries were computed with; entries from another handicap are not comparable
+    mutable int ttRemovedSuccessorsPercentage = 0;
+    // Proof and disproof numbers of the df-pn solver, see SearchOptions::dfpnNodeBudget
+    mutable DfpnSolver dfpnSolver;
+    // Atari extensions of SearchOptions in 1/EXTENSION_PLY of a ply
+    int atariExtensionUnits = 0;
+    int escapeExtensionUnits = 0;
+    // Late move reductions by [depth][move number], see SearchOptions::lateMoveReductions
+    std::array<std::array<uint8_t, BOARD_SIZE + 1>, MAX_PLY + 1> reductions{};
+
+    void initReductions() {
+        // Below depth 2 no reduction leaves a ply to search, whatever the options say
+        for (int depth = std::max(options.lmrMinDepth, 2); depth <= MAX_PLY; ++depth) {
+            for (int moveNumber = std::max(options.lmrFullDepthMoves, 0) + 1; moveNumber <= BOARD_SIZE; ++moveNumber) {
+                const double r = options.lmrBase + std::log(depth) * std::log(moveNumber) / options.lmrDivisor;
+                // Leave at least one ply, so the reduced search still plays a move
+                reductions[depth][moveNumber] = static_cast<uint8_t>(std::clamp(static_cast<int>(r), 0, depth - 2));
+            }
+        }
+    }
+
+    // State shared by every thread of one getBestMove call
+    struct SharedSearchState {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> nodeCount{0};
+        SearchControl *control = nullptr; // Set when the caller can stop the search, make it ponder or follow it
+
+        [[nodiscard]] bool isPondering() const {
+            return control && control->pondering.load(std::memory_order_relaxed);
+        }
+
+        // The search must end: it was stopped from outside, or the time is up and it is not pondering
+        [[nodiscard]] bool mustStop(const std::chrono::steady_clock::time_point start,
+                                    const std::chrono::milliseconds timeLimit) const {
+            if (control && control->stop.load(std::memory_order_relaxed)) return true;
+            return !isPondering() && std::chrono::steady_clock::now() - start >= timeLimit;
+        }
+    };
 
     struct SearchContext {
         const std::chrono::steady_clock::time_point start;
         const std::chrono::milliseconds timeLimit;
-        bool timedOut = false;
+        SharedSearchState &shared;
+        bool timedOut = false; // This thread must unwind: time is up or the search was stopped
         uint64_t nodeCount = 0;
-    };
+        uint64_t publishedNodeCount = 0; // Part of nodeCount already added to shared.nodeCount
+        std::array<Board::UndoRecord, MAX_PLY> undoStack{}; // undoStack[ply] reverts the move made at ply
+        // Atari extensions of the line leading to each ply: the fraction of a ply not used yet and the plies added
+        struct LineExtensions {
+            int credit = 0;
+            int plies = 0;
+        };
+        std::array<LineExtensions, MAX_PLY + 1> lineExtensions{}; // Written by the parent before each child
 
-    int minimax(const Board &state, int depth, int alpha, int beta, SearchContext &ctx, const int ply) const {
+        // Move ordering learned from cutoffs: two killer moves per ply and a history score per [color][point]
+        std::array<MovePicker::Killers, MAX_PLY> killers = makeEmptyKillers();
+        std::array<MovePicker::History, 2> history{};
+        uint64_t cutoffCount = 0; // Beta cutoffs
+        uint64_t firstMoveCutoffCount = 0; // Beta cutoffs produced by the first child searched
+        uint64_t pvsReSearchCount = 0; // Zero-window searches that failed high and were searched again
+        uint64_t lmrCount = 0; // Moves searched at reduced depth
+        uint64_t lmrReSearchCount = 0; // Reduced searches that beat the best move and were searched again
+        uint64_t probCutCount = 0; // Nodes pruned by ProbCut
+        uint64_t extensionCount = 0; // Moves searched one ply deeper by the atari extensions
+        uint64_t etcProbeCount = 0; // Nodes whose children were probed for an enhanced transposition cutoff
+        uint64_t etcCutoffCount = 0; // Of those, nodes cut without searching a child
+        uint64_t aspirationFailLowCount = 0; // Root searches repeated because the score fell below the window
+        uint64_t aspirationFailHighCount = 0; // Root searches repeated because the score rose above the window
+        uint64_t quiescenceNodeCount = 0; // Nodes searched past the nominal depth
+        uint64_t ladderWinCount = 0; // Nodes scored as won by a ladder read
 
-        // Check if the game is over or if we reached the maximum depth
-        if (depth == 0 || AtariGo::isTerminal(state)) return distanceAwareScore(state.getHeuristic(), ply);
+        static std::array<MovePicker::Killers, MAX_PLY> makeEmptyKillers() {
+            std::array<MovePicker::Killers, MAX_PLY> empty{};
+            for (auto &slot: empty) slot.fill(NO_MOVE);
+            return empty;
+        }
+
+        // A quiet move caused a beta cutoff: make it a killer of its ply and raise its history. The history update
+        // shrinks as the entry approaches HISTORY_MAX, which keeps every entry bounded.
+        void updateQuietStats(const int ply, const Player player, const int pos, const int depth) {
+            if (killers[ply][0] != pos) {
+                killers[ply][1] = killers[ply][0];
+                killers[ply][0] = pos;
+            }
+            int &entry = history[player == BLACK ? 0 : 1][pos];
+            const int bonus = std::min(depth * depth * 16, MovePicker::HISTORY_MAX);
+            entry += bonus - entry * bonus / MovePicker::HISTORY_MAX;
+        }
 
-        // Increment node count and occasionally check time
-        if (++ctx.nodeCount % CHECK_INTERVAL == 0) {
-            if (std::chrono::steady_clock::now() - ctx.start >= ctx.timeLimit) {
-                ctx.timedOut = true;
-                return 0;
+        // Counts a node and occasionally checks the time. Returns true if the search must unwind: running out of time
+        // or being stopped stops every thread.
+        bool countNode() {
+            if (++nodeCount % CHECK_INTERVAL == 0) {
+                publishNodeCount();
+                if (shared.mustStop(start, timeLimit)) shared.stop.store(true, std::memory_order_relaxed);
             }
+            if (shared.stop.load(std::memory_order_relaxed)) timedOut = true;
+            return timedOut;
+        }
+
+        void publishNodeCount() {
+            shared.nodeCount.fetch_add(nodeCount - publishedNodeCount, std::memory_order_relaxed);
+            if (shared.control)
+                shared.control->nodeCount.fetch_add(nodeCount - publishedNodeCount, std::memory_order_relaxed);
+            publishedNodeCount = nodeCount;
+        }
+    };
+
+    // A ladder the player to move wins is a forced line: score it as the capture it ends with
+    bool ladderWin(const Board &state, SearchContext &ctx, const int ply, int &score) const {
+        if (!options.ladders) return false;
+        const Ladder::Result ladder = Ladder::findCapture(state);
+        if (!ladder.captured) return false;
+        ++ctx.ladderWinCount;
+        score = distanceAwareScore(state.getPlayerToMove() == WHITE ? WIN : -WIN, ply + ladder.plies);
+        return true;
+    }
+
+    // Quiescence search, run instead of the heuristic at the nominal depth: the heuristic of a position where a group
+    // sits in atari is a guess about a capture that is decided one ply later. Only captures and atari escapes are
+    // played, found from the group liberties. The side to move stands pat (keeps the heuristic) unless it has a group
+    // in atari, since then not moving is not an option: the opponent captures.
+    int quiescence(Board &state, int alpha, int beta, SearchContext &ctx, const int ply) const {
+        if (AtariGo::isTerminal(state) || ply >= MAX_PLY) return distanceAwareScore(state.getHeuristic(), ply);
+        ++ctx.quiescenceNodeCount;
+        if (ctx.countNode()) return 0;
+
+        const Player toMove = state.getPlayerToMove();
+
+        // Any capture ends the game, so there is no need to play it
+        for (Bitboard128 slots = state.getGroupSlots(opponent(toMove)); slots;) {
+            if (bitCount(state.getGroup(popLSB(slots)).liberties) == 1)
+                return distanceAwareScore(toMove == WHITE ? WIN : -WIN, ply + 1);
         }
 
+        // Nothing to capture and nothing to save: the position is quiet, stand pat unless a ladder wins
+        Bitboard128 escapes = 0;
+        for (Bitboard128 slots = state.getGroupSlots(toMove); slots;) {
+            const Bitboard128 libs = state.getGroup(popLSB(slots)).liberties;
+            if (bitCount(libs) == 1) escapes |= libs;
+        }
+        if (!escapes) {
+            if (int score; ladderWin(state, ctx, ply, score)) return score;
+            return state.getHeuristic();
+        }
+
+        // With no capture available, the only way out of atari is to extend at the last liberty
+        Board::UndoRecord &undo = ctx.undoStack[ply];
+        int best = toMove == WHITE ? -INF : INF;
+        while (escapes) {
+            state.makeMove(popLSB(escapes), undo);
+            AtariGo::computeHeuristic(state);
+            const int score = quiescence(state, alpha, beta, ctx, ply + 1);
+            state.unmakeMove(undo);
+            if (ctx.timedOut) return 0;
+
+            if (toMove == WHITE ? score > best : score < best) best = score;
+            if (toMove == WHITE) alpha = std::max(alpha, best);
+            else beta = std::min(beta, best);
+            if (alpha >= beta) break;
+        }
+        return best;
+    }
+
+    // Searches `state` in place: children are played with makeMove and reverted with unmakeMove, so the board is back
+    // to its original position when this returns (also when the search times out).
+    int minimax(Board &state, int depth, int alpha, int beta, SearchContext &ctx, const int ply) const {
+
+        // Check if the game is over or if we reached the maximum depth
+        if (AtariGo::isTerminal(state)) return distanceAwareScore(state.getHeuristic(), ply);
+        if (depth == 0) {
+            if (options.quiescence) return quiescence(state, alpha, beta, ctx, ply);
+            return state.getHeuristic();
+        }
+
+        if (ctx.countNode()) return 0;
+
         // Check transposition table
         const uint64_t signature = state.getSignature();
-        if (const auto it = transpositionTable.find(signature); it != transpositionTable.end()) {
-            auto &[score, storedDepth, flag] = it->second;
+        int hashMove = NO_MOVE;
+        if (TranspositionTable::Data entry{}; transpositionTable.probe(signature, entry)) {
+            const auto &[score, storedDepth, flag, move] = entry;
+            hashMove = move;
             if (std::abs(score) >= (WIN - 20)) {
                 // If the score is a win or a loss, the depth is irrelevant. The -20 accounts for the ply value.
                 return score;
@@ -59,58 +331,395 @@ private:
             }
         }
 
-        // Generate successors
-        const auto successors = AtariGo::generateSuccessors(state);
-        if (successors.empty()) return distanceAwareScore(state.getHeuristic(), ply);
+        if (int score; ladderWin(state, ctx, ply, score)) {
+            transpositionTable.store(signature, score, depth, EXACT);
+            return score;
+        }
+
+        if (int score; options.enhancedTranspositionCutoffs && depth >= options.etcMinDepth
+                       && enhancedTranspositionCutoff(state, depth, alpha, beta, ctx, score)) {
+            return score;
+        }
+
+        if (int score; options.probCut && probCut(state, depth, alpha, beta, ctx, ply, score)) return score;
 
+        // Moves are produced lazily, hash move first: it was the best move, or the refutation, at a shallower depth.
         const Player toMove = state.getPlayerToMove();
+        MovePicker picker(state, hashMove, ctx.killers[ply], ctx.history[toMove == BLACK ? 0 : 1]);
+        Board::UndoRecord &undo = ctx.undoStack[ply];
+
         int best = toMove == WHITE ? -INF : INF;
+        int bestMove = NO_MOVE;
         const int origAlpha = alpha;
         const int origBeta = beta;
 
-        // Iterate through successors
-        for (auto &child: successors) {
-            int score = minimax(child, depth - 1, alpha, beta, ctx, ply + 1);
+        // Iterate through the moves, playing each one on the board and taking it back afterwards
+        int moveCount = 0;
+        const int parentHeuristic = state.getHeuristic();
+        for (int pos = picker.next(); pos != NO_MOVE; pos = picker.next()) {
+            ++moveCount;
+            const bool quiet = picker.isQuiet(pos);
+            state.makeMove(pos, undo);
+            AtariGo::computeHeuristic(state);
+            const int childDepth = depth - 1 + atariExtension(toMove, parentHeuristic, state.getHeuristic(), ctx, ply);
+            int score = 0;
+            bool settled = false; // The reduced search showed the move is no better than the best one so far
+            if (const int reduction = quiet ? reductions[std::min(depth, MAX_PLY)][moveCount] : 0; reduction > 0) {
+                // Late quiet move: a shallower zero-window search must show it beats the best move first
+                ++ctx.lmrCount;
+                if (toMove == WHITE) {
+                    score = minimax(state, childDepth - reduction, alpha, alpha + 1, ctx, ply + 1);
+                    settled = score <= alpha;
+                } else {
+                    score = minimax(state, childDepth - reduction, beta - 1, beta, ctx, ply + 1);
+                    settled = score >= beta;
+                }
+                if (!settled && !ctx.timedOut) ++ctx.lmrReSearchCount;
+            }
+            if (!settled && !ctx.timedOut) {
+                if (moveCount == 1 || !options.principalVariationSearch) {
+                    score = minimax(state, childDepth, alpha, beta, ctx, ply + 1);
+                } else {
+                    // Only prove that the move is not better than the best one so far. If it is, search it again with
+                    // the full window to get its real score.
+                    if (toMove == WHITE) {
+                        score = minimax(state, childDepth, alpha, alpha + 1, ctx, ply + 1);
+                        if (score > alpha && score < beta && !ctx.timedOut) {
+                            ++ctx.pvsReSearchCount;
+                            score = minimax(state, childDepth, alpha, beta, ctx, ply + 1);
+                        }
+                    } else {
+                        score = minimax(state, childDepth, beta - 1, beta, ctx, ply + 1);
+                        if (score < beta && score > alpha && !ctx.timedOut) {
+                            ++ctx.pvsReSearchCount;
+                            score = minimax(state, childDepth, alpha, beta, ctx, ply + 1);
+                        }
+                    }
+                }
+            }
+            state.unmakeMove(undo);
             if (ctx.timedOut) return 0;
 
-            if (toMove == WHITE) {
-                best = std::max(best, score);
-                alpha = std::max(alpha, best);
-            } else {
-                best = std::min(best, score);
-                beta = std::min(beta, best);
+            if (toMove == WHITE ? score > best : score < best) {
+                best = score;
+                bestMove = pos;
+            }
+            if (toMove == WHITE) alpha = std::max(alpha, best);
+            else beta = std::min(beta, best);
+
+            if (alpha >= beta) {
+                ++ctx.cutoffCount;
+                if (moveCount == 1) ++ctx.firstMoveCutoffCount;
+                if (picker.isQuiet(pos)) ctx.updateQuietStats(ply, toMove, pos, depth);
+                break;
             }
-            if (alpha >= beta) break;
         }
 
-        // Store the best score in the transposition table
+        if (moveCount == 0) return distanceAwareScore(state.getHeuristic(), ply);
+
+        // Store the best score and the move that produced it in the transposition table
         Bound flag = EXACT;
         if (best <= origAlpha) flag = UPPER;
         else if (best >= origBeta) flag = LOWER;
-        transpositionTable[signature] = {best, depth, flag};
+        transpositionTable.store(signature, best, depth, flag, bestMove);
 
         return best;
     }
 
-public:
-    Board getBestMove(const Board &state, const std::chrono::milliseconds timeLimit, const int depthLimit) const {
-        SearchContext ctx{std::chrono::steady_clock::now(), timeLimit};
+    // Atari extension of the move `mover` just played, in whole plies (0 or 1), and the line state of the child in
+    // ctx.lineExtensions[ply + 1]. Heuristics read from the mover's side are ATARI_THREAT_SCORE ahead when only the
+    // opponent is in atari, and as far behind when only the mover is: the move puts a group in atari if the child is
+    // ahead, and saves one if the parent was behind and the child is not.
+    int atariExtension(const Player mover, const int parentHeuristic, const int childHeuristic, SearchContext &ctx,
+                       const int ply) const {
+        SearchContext::LineExtensions line = ctx.lineExtensions[ply];
+        int extension = 0;
+        if (options.atariExtensions && line.plies < options.maxExtensionPlies) {
+            const int before = mover == WHITE ? parentHeuristic : -parentHeuristic;
+            const int after = mover == WHITE ? childHeuristic : -childHeuristic;
+            constexpr int threat = ATARI_THREAT_SCORE / 2;
+            if (std::abs(after) < WIN) {
+                if (after >= threat) line.credit += atariExtensionUnits;
+                else if (before <= -threat && after > -threat) line.credit += escapeExtensionUnits;
+            }
+            if (line.credit >= EXTENSION_PLY) {
+                line.credit -= EXTENSION_PLY;
+                ++line.plies;
+                ++ctx.extensionCount;
+                extension = 1;
+            }
+        }
+        ctx.lineExtensions[ply + 1] = line;
+        return extension;
+    }
+
+    // Enhanced transposition cutoff: returns true, with the child's score in `score`, if the table already holds a child
+    // searched deep enough whose bound refutes the window. Child signatures are the parent's with the mover's Zobrist
+    // value for the point XOR-ed in, exactly as makeMove computes them, so no move is played.
+    bool enhancedTranspositionCutoff(const Board &state, const int depth, const int alpha, const int beta,
+                                     SearchContext &ctx, int &score) const {
+        ++ctx.etcProbeCount;
+        const uint64_t signature = state.getSignature();
+        const bool white = state.getPlayerToMove() == WHITE;
+        const auto &zobrist = ZOBRIST_TABLE[white ? 1 : 0];
+        for (Bitboard128 moves = ~state.getOccupiedBits() & FULL_BOARD_MASK; moves;) {
+            const int pos = popLSB(moves);
+            TranspositionTable::Data entry{};
+            if (!transpositionTable.probe(signature ^ zobrist[pos], entry)) continue;
+            // Won and lost scores hold at any depth, as in the probe of minimax
+            if (entry.depth < depth - 1 && std::abs(entry.score) < WIN - 20) continue;
+            // The child's score is a lower bound on this node's for White, an upper bound for Black
+            const bool refutes = white
+                                     ? entry.bound != UPPER && entry.score >= beta
+                                     : entry.bound != LOWER && entry.score <= alpha;
+            if (!refutes) continue;
+            ++ctx.etcCutoffCount;
+            transpositionTable.store(signature, entry.score, depth, white ? LOWER : UPPER, pos);
+            score = entry.score;
+            return true;
+        }
+        return false;
+    }
+
+    // ProbCut: returns true, with the bound in `score`, if a shallow search predicts that the node fails high or low.
+    // Each side is tried with a zero window on the shallow score that predicts the deep one past the bound.
+    bool probCut(Board &state, const int depth, const int alpha, const int beta, SearchContext &ctx, const int ply,
+                 int &score) const {
+        const ProbCutModel *model = ProbCut::model(depth);
+        // Zero-window nodes only: a principal variation node needs its exact score
+        if (!model || beta - alpha > 1 || std::abs(alpha) >= ProbCut::MAX_SCORE || std::abs(beta) >= ProbCut::MAX_SCORE)
+            return false;
+        const int shallowDepth = depth - ProbCut::REDUCTION;
+        const double margin = options.probCutThreshold * model->sigma;
+
+        // Fails high if shallow >= (beta + margin - intercept) / slope
+        const int high = static_cast<int>(std::ceil((beta + margin - model->intercept) / model->slope));
+        if (std::abs(high) < ProbCut::MAX_SCORE) {
+            const int shallow = minimax(state, shallowDepth, high - 1, high, ctx, ply);
+            if (ctx.timedOut) return false;
+            if (shallow >= high) {
+                ++ctx.probCutCount;
+                score = beta;
+                return true;
+            }
+        }
+
+        const int low = static_cast<int>(std::floor((alpha - margin - model->intercept) / model->slope));
+        if (std::abs(low) < ProbCut::MAX_SCORE) {
+            const int shallow = minimax(state, shallowDepth, low, low + 1, ctx, ply);
+            if (ctx.timedOut) return false;
+            if (shallow <= low) {
+                ++ctx.probCutCount;
+                score = alpha;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Searches the root successors to `depth` inside the (alpha, beta) window. bestIdx lists the successors sharing
+    // the best score. If the best score is outside the window, it is only a bound (the search failed low or high)
+    // and bestIdx is meaningless. If ctx.timedOut is set on return, the results are incomplete and must be discarded.
+    void searchRoot(const std::vector<Board> &successors, const Player currentPlayer, const int depth,
+                    const int alpha, const int beta, SearchContext &ctx, int &bestScore,
+                    std::vector<int> &bestIdx) const {
+        bestScore = (currentPlayer == BLACK) ? INF : -INF;
+        bestIdx.clear();
+
+        for (int i = 0; i < static_cast<int>(successors.size()) && !ctx.timedOut; ++i) {
+            Board child = successors[i];
+            int score;
+            if (currentPlayer == WHITE) {
+                // Alpha is the bestScore found so far from previous siblings
+                score = minimax(child, depth - 1, std::max(alpha, bestScore - 1), beta, ctx, 0);
+            } else { // BLACK
+                // Beta is the bestScore found so far from previous siblings
+                score = minimax(child, depth - 1, alpha, std::min(beta, bestScore + 1), ctx, 0);
+            }
+
+            if (ctx.timedOut) break;
+
+            // Update best score and best move(s) for the current depth
+            if (currentPlayer == WHITE) {
+                if (score > bestScore || bestIdx.empty()) {
+                    bestScore = score; // Update alpha
+                    bestIdx = {i};
+                } else if (score == bestScore) {
+                    bestIdx.push_back(i);
+                }
+            } else { // BLACK
+                if (score < bestScore || bestIdx.empty()) {
+                    bestScore = score; // Update beta
+                    bestIdx = {i};
+                } else if (score == bestScore) {
+                    bestIdx.push_back(i);
+                }
+            }
+
+            // Failed high (low for Black): the window has to be widened anyway, no need to search the other moves
+            if (currentPlayer == WHITE ? bestScore >= beta : bestScore <= alpha) break;
+        }
+    }
+
+    // Multi-PV root search to `depth`: the moves are searched in `order` (best first from the previous depth). Until
+    // lineCount moves have exact scores, every move is searched with a full window; past that, a move is first tested
+    // with a zero window against the worst of the top lines and only searched again with a full window if it beats it.
+    // On return, `order` lists the moves best first, the first lineCount of them with exact scores in `scores`; the
+    // scores of the others are bounds. If ctx.timedOut is set on return, the results are incomplete.
+    void searchRootLines(const std::vector<Board> &successors, const Player currentPlayer, const int depth,
+                         const int lineCount, SearchContext &ctx, std::vector<int> &order,
+                         std::vector<int> &scores) const {
+        const bool white = currentPlayer == WHITE;
+        auto better = [white](const int a, const int b) { return white ? a > b : a < b; };
+        std::vector<int> top; // Moves with exact scores, best first, at most lineCount of them
+
+        for (const int i: order) {
+            Board child = successors[i];
+            int score;
+            if (static_cast<int>(top.size()) < lineCount) {
+                score = minimax(child, depth - 1, -INF, INF, ctx, 0);
+            } else {
+                const int worst = scores[top.back()];
+                score = white
+                            ? minimax(child, depth - 1, worst, worst + 1, ctx, 0)
+                            : minimax(child, depth - 1, worst - 1, worst, ctx, 0);
+                if (better(score, worst) && !ctx.timedOut) score = minimax(child, depth - 1, -INF, INF, ctx, 0);
+            }
+            if (ctx.timedOut) return;
+
+            scores[i] = score;
+            if (static_cast<int>(top.size()) < lineCount || better(score, scores[top.back()])) {
+                // After the moves with the same score, so that ties keep the order of the previous depth
+                const auto at = std::find_if(top.begin(), top.end(), [&](const int j) { return better(score, scores[j]); });
+                top.insert(at, i);
+                if (static_cast<int>(top.size()) > lineCount) top.pop_back();
+            }
+        }
+
+        std::vector<int> rest;
+        for (const int i: order) {
+            if (std::find(top.begin(), top.end(), i) == top.end()) rest.push_back(i);
+        }
+        std::stable_sort(rest.begin(), rest.end(), [&](const int a, const int b) { return better(scores[a], scores[b]); });
+        order = top;
+        order.insert(order.end(), rest.begin(), rest.end());
+    }
+
+    // The moves the transposition table expects from `state` on, at most `maxLength` of them. Entries overwritten since
+    // the search cut the line short.
+    std::vector<int> principalVariation(Board state, const int maxLength) const {
+        std::vector<int> pv;
+        while (static_cast<int>(pv.size()) < maxLength && !AtariGo::isTerminal(state)) {
+            TranspositionTable::Data entry{};
+            if (!transpositionTable.probe(state.getSignature(), entry)) break;
+            if (entry.move == NO_MOVE || !state.isEmpty(entry.move)) break;
+            pv.push_back(entry.move);
+            state.setStone(entry.move);
+            AtariGo::computeHeuristic(state);
+        }
+        return pv;
+    }
 
+    // The score a depth is expected to end on: the last completed depth of the same parity. The heuristic swings by about
+    // MIN_LIB_MULTIPLIER between odd and even depths (whoever moved last is ahead), so the previous depth is a poor guess.
+    static int expectedScore(const std::vector<int> &completedScores) {
+        return completedScores.size() >= 2 ? completedScores[completedScores.size() - 2] : 0;
+    }
+
+    // Searches the root to `depth` inside an aspiration window around the expected score, widened on the failing side
+    // until the score fits.
+    void aspirationSearch(const std::vector<Board> &successors, const Player currentPlayer, const int depth,
+                          const std::vector<int> &completedScores, SearchContext &ctx, int &bestScore,
+                          std::vector<int> &bestIdx) const {
+        const int center = expectedScore(completedScores);
+        int delta = ASPIRATION_DELTA;
+        const bool aspirate = options.aspirationWindows && completedScores.size() >= 2
+                              && std::abs(center) < WIN - MAX_PLY;
+        int alpha = aspirate ? center - delta : -INF;
+        int beta = aspirate ? center + delta : INF;
+        while (true) {
+            searchRoot(successors, currentPlayer, depth, alpha, beta, ctx, bestScore, bestIdx);
+            if (ctx.timedOut) return;
+
+            const bool failLow = bestScore <= alpha && alpha > -INF;
+            const bool failHigh = bestScore >= beta && beta < INF;
+            if (!failLow && !failHigh) return;
+
+            delta *= 4;
+            if (failLow) {
+                ++ctx.aspirationFailLowCount;
+                alpha = delta > ASPIRATION_MAX_DELTA ? -INF : center - delta;
+            } else {
+                ++ctx.aspirationFailHighCount;
+                beta = delta > ASPIRATION_MAX_DELTA ? INF : center + delta;
+            }
+        }
+    }
+
+    // MTD(f): zero-window root searches starting at the expected score. Each pass returns a bound that narrows
+    // [lower, upper] until both meet at the score. Only a pass that proves the mover's bound (a fail high for White,
+    // a fail low for Black) identifies a best move, so bestIdx is taken from the last such pass; it holds that one move
+    // rather than every move sharing the score. `passes` gets the number of root searches.
+    void mtdf(const std::vector<Board> &successors, const Player currentPlayer, const int depth,
+              const std::vector<int> &completedScores, SearchContext &ctx, int &bestScore,
+              std::vector<int> &bestIdx, int &passes) const {
+        int guess = expectedScore(completedScores);
+        if (std::abs(guess) >= WIN - MAX_PLY) guess = 0;
+        int lower = -INF, upper = INF;
+        std::vector<int> passIdx;
+        bestIdx.clear();
+        for (passes = 0; lower < upper; ) {
+            if (passes == MTDF_MAX_PASSES) {
+                // Search instability keeps the bounds apart: settle the depth with a full window
+                ++passes;
+                searchRoot(successors, currentPlayer, depth, -INF, INF, ctx, bestScore, bestIdx);
+                return;
+            }
+            const int beta = guess == lower ? guess + 1 : guess;
+            searchRoot(successors, currentPlayer, depth, beta - 1, beta, ctx, guess, passIdx);
+            ++passes;
+            if (ctx.timedOut) return;
+            if (guess < beta) upper = guess;
+            else lower = guess;
+            if (currentPlayer == WHITE ? guess >= beta : guess < beta) bestIdx = passIdx;
+        }
+        bestScore = guess;
+    }
+
+    // Iterative deepening of a Lazy SMP helper. Odd helpers run one ply ahead of the main thread so that the threads
+    // spread over different depths instead of all searching the same subtrees in lockstep.
+    void helperSearch(std::vector<Board> successors, const Player currentPlayer, const int depthLimit,
+                      const int threadId, SearchContext &ctx) const {
+        for (int depth = 1 + (threadId & 1); depth <= depthLimit && !ctx.timedOut; ++depth) {
+            int bestScore;
+            std::vector<int> bestIdx;
+            searchRoot(successors, currentPlayer, depth, -INF, INF, ctx, bestScore, bestIdx);
+            if (ctx.timedOut || bestIdx.empty()) break;
+
+            for (int k = 0; k < static_cast<int>(bestIdx.size()); ++k)
+                std::swap(successors[k], successors[bestIdx[k]]);
+        }
+        ctx.publishNodeCount();
+    }
+
+    // The moves searched at the root: the generated successors plus a random opening move and the centre. Sets the
+    // handicap of the level `depthLimit` stands for (AtariGo::removeRandomSuccessorsPercentage).
+    std::vector<Board> rootSuccessors(const Board &state, const int depthLimit, const bool logging) const {
         // This will make the lower depths more accessible.
         if (depthLimit <= 2) {
-            std::cout << "Warning: Removing 80% of successors.\n";
+            if (logging) std::cout << "Warning: Removing 80% of successors.\n";
             AtariGo::removeRandomSuccessorsPercentage = 80;
         }
         else if (depthLimit <= 3) {
-            std::cout << "Warning: Removing 50% of successors.\n";
+            if (logging) std::cout << "Warning: Removing 50% of successors.\n";
             AtariGo::removeRandomSuccessorsPercentage = 50;
         }
         else if (depthLimit <= 4) {
-            std::cout << "Warning: Removing 20% of successors.\n";
+            if (logging) std::cout << "Warning: Removing 20% of successors.\n";
             AtariGo::removeRandomSuccessorsPercentage = 20;
         }
         else {
-            std::cout << "Removing no successors.\n";
+            if (logging) std::cout << "Removing no successors.\n";
             AtariGo::removeRandomSuccessorsPercentage = 0;
         }
 
@@ -145,7 +754,206 @@ public:
             AtariGo::computeHeuristic(center);
             successors.push_back(center);
         }
+        return successors;
+    }
+
+    // Starts the table generation of a new search. Entries of the previous searches are kept but age, so they are the
+    // first to be replaced; a change of handicap clears them, as they were searched with other moves removed.
+    void startTableGeneration() const {
+        if (ttRemovedSuccessorsPercentage != AtariGo::removeRandomSuccessorsPercentage) {
+            transpositionTable.clear();
+            ttRemovedSuccessorsPercentage = AtariGo::removeRandomSuccessorsPercentage;
+        } else {
+            transpositionTable.newSearch();
+        }
+    }
+
+    // Position after a move proved to win before the alpha-beta search, reported as a win to the control
+    static Board playProvedWin(const Board &state, const int move, SearchControl *control) {
+        Board result = state;
+        result.setStone(move);
+        AtariGo::computeHeuristic(result);
+        if (control) {
+            std::lock_guard<std::mutex> lock(control->progressMutex);
+            control->completedDepth = 1; // No iteration ran, but the move is settled: report it as a completed depth
+            control->score = state.getPlayerToMove() == WHITE ? WIN : -WIN;
+            control->bestMove = move;
+        }
+        return result;
+    }
+
+public:
+    explicit MiniMax(const SearchOptions &options = {})
+        : transpositionTable(options.ttSizeMb), options(options), dfpnSolver(options.dfpnTtSizeMb) {
+        if (options.lateMoveReductions) initReductions();
+        atariExtensionUnits = static_cast<int>(std::lround(options.atariExtension * EXTENSION_PLY));
+        escapeExtensionUnits = static_cast<int>(std::lround(options.escapeExtension * EXTENSION_PLY));
+    }
+
+    /// Forgets everything learned by previous searches, e.g. when a new game starts.
+    void clearTranspositionTable() { transpositionTable.clear(); }
+
+    /// Analysis: tries to prove `state` won or lost for the player to move with df-pn, no matter how deep the proof.
+    /// On MOVER_WINS, `winningMove` is set to a move that keeps the win.
+    DfpnSolver::Outcome solve(const Board &state, const uint64_t maxNodes, const std::chrono::milliseconds timeLimit,
+                              int &winningMove) const {
+        const DfpnSolver::Outcome outcome = dfpnSolver.solve(state, maxNodes, timeLimit);
+        winningMove = outcome == DfpnSolver::MOVER_WINS ? dfpnSolver.winningMove(state) : NO_MOVE;
+        return outcome;
+    }
+
+    [[nodiscard]] uint64_t getSolverNodeCount() const { return dfpnSolver.getNodeCount(); }
+
+    /// Analysis: the score of `state` searched to exactly `depth` with a full window and no time limit. The
+    /// transposition table is used and kept, as in a search.
+    [[nodiscard]] int searchScore(const Board &state, const int depth) const {
+        SharedSearchState shared;
+        SearchContext ctx{std::chrono::steady_clock::now(), std::chrono::hours(24), shared};
+        Board board = state;
+        AtariGo::computeHeuristic(board);
+        return minimax(board, depth, -INF, INF, ctx, 0);
+    }
+
+    /// The reply to `state` that the previous searches expect, read from the transposition table, or NO_MOVE.
+    /// `state` is usually the position right after the engine's own move: its best reply is the one to ponder on.
+    [[nodiscard]] int expectedReply(const Board &state) const {
+        TranspositionTable::Data entry{};
+        if (!transpositionTable.probe(state.getSignature(), entry)) return NO_MOVE;
+        if (entry.move == NO_MOVE || !state.isEmpty(entry.move)) return NO_MOVE;
+        return entry.move;
+    }
+
+    /// Analysis: the `lineCount` best moves of `state`, best first, with exact scores and principal variations. One
+    /// iterative-deepening search ranks every empty point (see searchRootLines) until `timeLimit` or `depthLimit`, and
+    /// the lines of the last completed depth are returned. The transposition table is shared with the other searches.
+    [[nodiscard]] std::vector<RootLine> getTopMoves(const Board &state, const std::chrono::milliseconds timeLimit,
+                                                    const int depthLimit, const int lineCount) const {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<RootLine> lines;
+        if (lineCount <= 0 || AtariGo::isTerminal(state)) return lines;
+
+        // Analysis ranks every move, so no handicap
+        AtariGo::removeRandomSuccessorsPercentage = 0;
+        if (ttRemovedSuccessorsPercentage != 0) {
+            transpositionTable.clear();
+            ttRemovedSuccessorsPercentage = 0;
+        } else {
+            transpositionTable.newSearch();
+        }
+
+        std::vector<Board> successors;
+        std::vector<int> moves;
+        for (Bitboard128 empty = ~state.getOccupiedBits() & FULL_BOARD_MASK; empty;) {
+            const int pos = popLSB(empty);
+            Board &successor = successors.emplace_back(state);
+            successor.setStone(pos);
+            AtariGo::computeHeuristic(successor);
+            moves.push_back(pos);
+        }
+        const int moveCount = static_cast<int>(successors.size());
+
+        std::vector<int> order(moveCount), scores(moveCount);
+        for (int i = 0; i < moveCount; ++i) order[i] = i;
+
+        const Player currentPlayer = state.getPlayerToMove();
+        SharedSearchState shared;
+        SearchContext ctx{start, timeLimit, shared};
+
+        // No line can be longer than the number of empty points
+        for (int depth = 1; depth <= std::min(depthLimit, moveCount) && !ctx.timedOut; ++depth) {
+            std::vector<int> depthOrder = order;
+            searchRootLines(successors, currentPlayer, depth, lineCount, ctx, depthOrder, scores);
+            ctx.publishNodeCount();
+            if (ctx.timedOut) break;
+            order = depthOrder;
+
+            lines.clear();
+            for (int k = 0; k < std::min(lineCount, moveCount); ++k) {
+                const int i = order[k];
+                RootLine &line = lines.emplace_back();
+                line.move = moves[i];
+                line.score = scores[i];
+                line.depth = depth;
+                line.pv = {moves[i]};
+                const std::vector<int> rest = principalVariation(successors[i], depth - 1);
+                line.pv.insert(line.pv.end(), rest.begin(), rest.end());
+            }
+
+            const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - ctx.start).count();
+            std::cout << "Completed depth " << depth << ". Lines:";
+            for (const RootLine &line: lines) std::cout << " " << line.move << " (" << line.score << ")";
+            std::cout << ". Nodes: " << shared.nodeCount.load(std::memory_order_relaxed)
+                    << ". Time: " << elapsedMs << " ms\n";
+        }
+        return lines;
+    }
+
+    /// Pondering in slices, for callers with no thread to spare (the web worker). One session is one search: it keeps
+    /// the root moves, in the order the completed depths left them, and the depth to search next.
+    struct PonderSession {
+        uint64_t signature = 0; // Position pondered on, 0 before the first slice
+        std::vector<Board> successors;
+        std::vector<int> completedScores; // Best score of each completed depth
+        int depth = 1; // Next depth to search
+        bool finished = false; // The depth limit was reached or the result is proved
+    };
+
+    /// Ponders on `state` for about `slice`, resuming `session` where its last slice stopped; a session for another
+    /// position is started over. A depth interrupted by the end of the slice is searched again by the next one, which
+    /// finds the work done in the transposition table. The whole session uses one table generation and logs nothing.
+    /// Returns whether more slices can still help.
+    bool ponderSlice(const Board &state, const std::chrono::milliseconds slice, const int depthLimit,
+                     PonderSession &session) const {
+        const auto start = std::chrono::steady_clock::now();
+        if (session.signature != state.getSignature()) {
+            session = {};
+            session.signature = state.getSignature();
+            if (!AtariGo::isTerminal(state)) session.successors = rootSuccessors(state, depthLimit, false);
+            session.finished = session.successors.size() <= 1;
+            startTableGeneration();
+        }
 
+        const Player currentPlayer = state.getPlayerToMove();
+        SharedSearchState shared;
+        SearchContext ctx{start, slice, shared};
+        while (!session.finished && session.depth <= depthLimit) {
+            int bestScore;
+            std::vector<int> bestIdx;
+            int passes = 0;
+            if (options.mtdf) {
+                mtdf(session.successors, currentPlayer, session.depth, session.completedScores, ctx, bestScore, bestIdx,
+                     passes);
+            } else {
+                aspirationSearch(session.successors, currentPlayer, session.depth, session.completedScores, ctx,
+                                 bestScore, bestIdx);
+            }
+            if (ctx.timedOut) return true;
+            if (bestIdx.empty()) break;
+
+            session.completedScores.push_back(bestScore);
+            for (int k = 0; k < static_cast<int>(bestIdx.size()); ++k)
+                std::swap(session.successors[k], session.successors[bestIdx[k]]);
+            ++session.depth;
+            if (std::abs(bestScore) >= WIN) break;
+        }
+        session.finished = true;
+        return false;
+    }
+
+    /// Searches `state` on a background thread, see SearchHandle. The engine must not run another search until this one
+    /// is finished. With `ponder`, the search starts with its clock held (see SearchControl::pondering).
+    [[nodiscard]] std::unique_ptr<SearchHandle> startSearch(const Board &state, std::chrono::milliseconds timeLimit,
+                                                            int depthLimit, bool ponder = false) const;
+
+    /// Searches `state` by iterative deepening until `timeLimit` or `depthLimit` is reached and returns the resulting
+    /// position. With a `control`, another thread can stop the search early, let it ponder or follow its progress.
+    Board getBestMove(const Board &state, const std::chrono::milliseconds timeLimit, const int depthLimit,
+                      SearchControl *control = nullptr) const {
+        const auto start = std::chrono::steady_clock::now();
+        const bool logging = !(control && control->pondering.load(std::memory_order_relaxed));
+
+        std::vector<Board> successors = rootSuccessors(state, depthLimit, logging);
 
         if (successors.empty()) {
             std::cerr << "Warning: No successors generated from the current state.\n";
@@ -153,66 +961,122 @@ public:
         }
         if (successors.size() == 1) return successors[0];
 
-        transpositionTable.clear();
-        // transpositionTable.reserve(10'000'000);
+        // Forced captures need no alpha-beta search. Skipped on the handicapped levels, which must stay beatable.
+        if (options.lambdaOrder > 0 && AtariGo::removeRandomSuccessorsPercentage == 0) {
+            LambdaSearch lambda(state, options.lambdaOrder, options.lambdaDepth, options.lambdaNodeBudget);
+            if (const int move = lambda.findWin(); move != NO_MOVE) {
+                if (logging) {
+                    std::cout << "Lambda search proved a win with " << move << " in " << lambda.getNodeCount()
+                            << " nodes.\n";
+                }
+                return playProvedWin(state, move, control);
+            }
+        }
+        if (options.dfpnNodeBudget > 0 && AtariGo::removeRandomSuccessorsPercentage == 0) {
+            const DfpnSolver::Outcome outcome = dfpnSolver.solve(state, options.dfpnNodeBudget, timeLimit / 10);
+            const int move = outcome == DfpnSolver::MOVER_WINS ? dfpnSolver.winningMove(state) : NO_MOVE;
+            if (move != NO_MOVE) {
+                if (logging) {
+                    std::cout << "Df-pn proved a win with " << move << " in " << dfpnSolver.getNodeCount()
+                            << " nodes.\n";
+                }
+                return playProvedWin(state, move, control);
+            }
+        }
+
+        startTableGeneration();
         int overallBestScore = 0;
         std::vector<int> overallBestIdx;
+        std::vector<int> completedScores; // Best score of each completed depth
 
         const Player currentPlayer = state.getPlayerToMove();
+        SharedSearchState shared;
+        shared.control = control;
+        SearchContext ctx{start, timeLimit, shared};
+        TimeManager timeManager(start, timeLimit);
+
+        // Lazy SMP: the helpers run the same iterative deepening on their own copy of the root. They never report a
+        // move; their only output is the TT entries the main thread then finds.
+        std::vector<std::thread> helpers;
+        for (int id = 1; id < options.threads; ++id) {
+            helpers.emplace_back([this, successors, currentPlayer, depthLimit, id, start, timeLimit, &shared] {
+                SearchContext helperCtx{start, timeLimit, shared};
+                helperSearch(successors, currentPlayer, depthLimit, id, helperCtx);
+            });
+        }
 
         for (int depth = 1; depth <= depthLimit && !ctx.timedOut; ++depth) {
-            int bestScore = (currentPlayer == BLACK) ? INF : -INF;
+            int bestScore;
             std::vector<int> bestIdx;
 
-            // Process remaining successors
-            for (int i = 0; i < static_cast<int>(successors.size()) && !ctx.timedOut; ++i) {
-                int score;
-                if (currentPlayer == WHITE) {
-                    // Alpha is the bestScore found so far from previous siblings, Beta is INF
-                    score = minimax(successors[i], depth - 1, bestScore - 1, INF, ctx, 0);
-                } else { // BLACK
-                    // Alpha is -INF, Beta is the bestScore found so far from previous siblings
-                    score = minimax(successors[i], depth - 1, -INF, bestScore + 1, ctx, 0);
-                }
+            int passes = 0; // Zero-window root searches of MTD(f)
+            if (options.mtdf) mtdf(successors, currentPlayer, depth, completedScores, ctx, bestScore, bestIdx, passes);
+            else aspirationSearch(successors, currentPlayer, depth, completedScores, ctx, bestScore, bestIdx);
+            ctx.publishNodeCount();
 
-                if (ctx.timedOut) break;
+            if (!ctx.timedOut && !bestIdx.empty()) {
+                overallBestScore = bestScore;
+                completedScores.push_back(bestScore);
 
-                // Update best score and best move(s) for the current depth
-                if (currentPlayer == WHITE) {
-                    if (score > bestScore || bestIdx.empty()) {
-                        bestScore = score; // Update alpha
-                        bestIdx = {i};
-                    } else if (score == bestScore) {
-                        bestIdx.push_back(i);
-                    }
-                } else { // BLACK
-                    if (score < bestScore || bestIdx.empty()) {
-                        bestScore = score; // Update beta
-                        bestIdx = {i};
-                    } else if (score == bestScore) {
-                        bestIdx.push_back(i);
-                    }
+                // Move this depth's best candidates to the front so the next iteration searches them first
+                overallBestIdx.clear();
+                for (int k = 0; k < static_cast<int>(bestIdx.size()); ++k) {
+                    std::swap(successors[k], successors[bestIdx[k]]);
+                    overallBestIdx.push_back(k);
                 }
-            }
 
-            if (!ctx.timedOut && !bestIdx.empty()) {
-                overallBestScore = bestScore;
-                overallBestIdx = bestIdx;
+                if (!shared.isPondering()) {
+                    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - ctx.start).count();
+                    const uint64_t nodeCount = shared.nodeCount.load(std::memory_order_relaxed);
 
-                const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::steady_clock::now() - ctx.start).count();
+                    std::cout << "Completed depth " << depth
+                            << ". Best score: " << overallBestScore
+                            << ". Candidates: " << bestIdx.size()
+                            << ". Nodes: " << nodeCount
+                            << ". NPS: " << nodeCount * 1000 / (elapsedMs + 1)
+                            << ". First-move cutoffs: " << (ctx.cutoffCount ? 100 * ctx.firstMoveCutoffCount / ctx.cutoffCount : 0) << "%"
+                            << ". PVS re-searches: " << ctx.pvsReSearchCount
+                            << ". LMR (reduced/re-searched): " << ctx.lmrCount << "/" << ctx.lmrReSearchCount
+                            << ". ProbCut cuts: " << ctx.probCutCount
+                            << ". Atari extensions: " << ctx.extensionCount
+                            << ". ETC (probed/cut): " << ctx.etcProbeCount << "/" << ctx.etcCutoffCount
+                            << (options.mtdf ? ". MTD(f) passes: " + std::to_string(passes) : "")
+                            << ". Aspiration fails (low/high): " << ctx.aspirationFailLowCount << "/" << ctx.aspirationFailHighCount
+                            << ". Quiescence nodes: " << ctx.quiescenceNodeCount
+                            << ". Ladder wins: " << ctx.ladderWinCount
+                            << ". TT Fill: " << transpositionTable.hashfull() / 10.0 << "%"
+                            << ". Time: " << elapsedMs << " ms\n";
+                }
 
-                std::cout << "Completed depth " << depth
-                        << ". Best score: " << overallBestScore
-                        << ". Candidates: " << bestIdx.size()
-                        << ". Nodes: " << ctx.nodeCount
-                        << ". TT Size: " << transpositionTable.size()
-                        << ". Time: " << elapsedMs << " ms\n";
+                if (control) {
+                    std::lock_guard<std::mutex> lock(control->progressMutex);
+                    control->completedDepth = depth;
+                    control->score = overallBestScore;
+                    control->bestMove = getLSBIndex(successors[0].getOccupiedBits() ^ state.getOccupiedBits());
+                }
 
                 if (std::abs(overallBestScore) >= WIN) break;
+
+                // The best candidates are at the front now, so the first one identifies the best move
+                timeManager.iterationCompleted(successors[0].getSignature());
+                if (options.timeManagement && !shared.isPondering() && depth < depthLimit) {
+                    const TimeManager::Decision decision = timeManager.nextIteration();
+                    if (decision != TimeManager::CONTINUE) {
+                        std::cout << "Stopping after depth " << depth << ": "
+                                << (decision == TimeManager::STOP_SOFT_LIMIT
+                                        ? "soft time limit reached"
+                                        : "the next depth would not finish in time")
+                                << ". Best move stable for " << timeManager.getStableIterations() << " depth(s).\n";
+                        break;
+                    }
+                }
             }
         }
 
+        shared.stop.store(true, std::memory_order_relaxed);
+        for (auto &helper: helpers) helper.join();
+
         if (overallBestIdx.empty()) {
             std::cerr << "Error: No best move identified after search. Returning first successor.\n";
             // Fallback to first successor if search was interrupted early or no valid moves found by search logic
@@ -227,3 +1091,77 @@ public:
         return successors[overallBestIdx[dist(getRandom())]];
     }
 };
+
+/// A search running on its own thread. It can be followed with poll, interrupted with stop (the search then returns the
+/// best move of its last completed depth) and waited for with or without a timeout. Destroying the handle stops the
+/// search and waits for it.
+class SearchHandle {
+private:
+    MiniMax::SearchControl control;
+    Board result;
+    mutable std::mutex mutex;
+    std::condition_variable finishedCondition;
+    bool finished = false;
+    std::thread thread; // Last, so that everything it uses is constructed before it starts
+
+public:
+    SearchHandle(const MiniMax &engine, const Board &state, const std::chrono::milliseconds timeLimit,
+                 const int depthLimit, const bool ponder) {
+        control.pondering = ponder;
+        thread = std::thread([this, &engine, state, timeLimit, depthLimit] {
+            Board best = engine.getBestMove(state, timeLimit, depthLimit, &control);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                result = best;
+                finished = true;
+            }
+            finishedCondition.notify_all();
+        });
+    }
+
+    SearchHandle(const SearchHandle &) = delete;
+    SearchHandle &operator=(const SearchHandle &) = delete;
+
+    ~SearchHandle() {
+        stop();
+        thread.join();
+    }
+
+    /// Asks the search to return as soon as possible. Returns immediately, use wait or get for the result.
+    void stop() { control.stop.store(true, std::memory_order_relaxed); }
+
+    /// Starts the clock of a search started with ponder: the time spent so far counts against its limit.
+    void ponderHit() { control.pondering.store(false, std::memory_order_relaxed); }
+
+    [[nodiscard]] SearchProgress poll() const {
+        SearchProgress progress;
+        {
+            std::lock_guard<std::mutex> lock(control.progressMutex);
+            progress.depth = control.completedDepth;
+            progress.score = control.score;
+            progress.bestMove = control.bestMove;
+        }
+        progress.nodeCount = control.nodeCount.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.finished = finished;
+        return progress;
+    }
+
+    /// Waits up to `timeout` for the search to finish. Returns whether it did.
+    bool wait(const std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return finishedCondition.wait_for(lock, timeout, [this] { return finished; });
+    }
+
+    /// Waits for the search to finish and returns the position after the best move.
+    Board get() {
+        std::unique_lock<std::mutex> lock(mutex);
+        finishedCondition.wait(lock, [this] { return finished; });
+        return result;
+    }
+};
+
+inline std::unique_ptr<SearchHandle> MiniMax::startSearch(const Board &state, const std::chrono::milliseconds timeLimit,
+                                                          const int depthLimit, const bool ponder) const {
+    return std::make_unique<SearchHandle>(*this, state, timeLimit, depthLimit, ponder);
+}
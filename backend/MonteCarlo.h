@@ -0,0 +1,418 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AtariGo.h"
+#include "BBUtils.h"
+#include "Board.h"
+#include "Playout.h"
+
+// Node pool size. As for the transposition table, the web builds get a smaller one.
+#ifdef __EMSCRIPTEN__
+constexpr size_t DEFAULT_MCTS_POOL_SIZE_MB = 32;
+#else
+constexpr size_t DEFAULT_MCTS_POOL_SIZE_MB = 256;
+#endif
+
+struct MonteCarloOptions {
+    // Tree-parallel search: threads sharing one tree, including the calling thread
+    int threads = 1;
+    // Memory for the tree nodes, split in two halves: the search grows the tree in one, and the subtree kept for the
+    // next move is copied to the other
+    size_t poolSizeMb = DEFAULT_MCTS_POOL_SIZE_MB;
+    // UCT exploration constant, applied to win rates in [0, 1]
+    double exploration = 0.25;
+    // RAVE: number of visits at which a child's own win rate and its all-moves-as-first win rate weigh the same. 0
+    // disables RAVE.
+    double raveEquivalence = 300;
+    // Losses added to a node while a thread is below it, so the other threads spread out to other moves
+    int virtualLoss = 3;
+    // A leaf is expanded once it has been visited this many times; before that it only runs playouts
+    uint32_t expandVisits = 4;
+    Playout::Policy playoutPolicy = Playout::LIGHT;
+};
+
+/// Monte Carlo Tree Search: UCT with RAVE, as an alternative engine to MiniMax. It needs no evaluation function; each
+/// simulation descends the tree, plays the game out at random to the first capture and counts who won.
+///
+/// The nodes come from a fixed pool and are addressed by index; the children of a node are contiguous. The tree is
+/// kept between moves: the next search starts from the node of the new position if the previous tree reached it.
+/// All threads share the tree without locks, the statistics being atomic counters. Expanding a node is claimed with
+/// a compare-and-swap, and the other threads run a playout from that leaf in the meantime.
+class MonteCarlo {
+private:
+    static constexpr uint8_t UNEXPANDED = 0;
+    static constexpr uint8_t EXPANDING = 1;
+    static constexpr uint8_t EXPANDED = 2;
+    static constexpr uint32_t ROOT = 0;
+    static constexpr int MAX_DEPTH = BOARD_SIZE + 1;
+
+    // 32 bytes. Wins are counted for the player who played `move`, which is how the parent compares its children.
+    struct Node {
+        std::atomic<uint32_t> visits{0};
+        std::atomic<uint32_t> wins{0};
+        std::atomic<uint32_t> raveVisits{0};
+        std::atomic<uint32_t> raveWins{0};
+        std::atomic<int32_t> virtualLoss{0};
+        uint32_t firstChild = 0;
+        uint16_t childCount = 0;
+        int8_t move = NO_MOVE;
+        std::atomic<uint8_t> expansion{UNEXPANDED};
+        // Proven result for the player who played `move`: 1 won, -1 lost, 0 unknown
+        std::atomic<int8_t> outcome{0};
+
+        void reset(const int pos) {
+            visits.store(0, std::memory_order_relaxed);
+            wins.store(0, std::memory_order_relaxed);
+            raveVisits.store(0, std::memory_order_relaxed);
+            raveWins.store(0, std::memory_order_relaxed);
+            virtualLoss.store(0, std::memory_order_relaxed);
+            firstChild = 0;
+            childCount = 0;
+            move = static_cast<int8_t>(pos);
+            expansion.store(UNEXPANDED, std::memory_order_relaxed);
+            outcome.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    static_assert(sizeof(Node) == 32, "MCTS nodes must stay packed");
+    static_assert(BOARD_SIZE <= 127, "Board positions must fit in a node");
+
+    const MonteCarloOptions options;
+    std::unique_ptr<Node[]> pools[2];
+    size_t poolCapacity = 0; // Nodes in each half
+    int activePool = 0;
+    std::atomic<uint32_t> poolUsed{0};
+    std::atomic<bool> poolFull{false};
+
+    Board rootBoard; // Position of the root node, once a search has run
+    bool hasTree = false;
+
+    Node *nodes() const { return pools[activePool].get(); }
+
+    static Player other(const Player p) { return p == BLACK ? WHITE : BLACK; }
+
+    // Liberties of the group holding the stone just played at `pos`
+    static int libertiesAfter(const Board &board, const int pos) { return bitCount(board.getGroupAt(pos).liberties); }
+
+    // The points of the player to move's groups in atari that save them all, and whether there are any such groups
+    static Bitboard128 atariEscapes(const Board &board, bool &inAtari) {
+        Bitboard128 escapes = 0;
+        inAtari = false;
+        for (Bitboard128 slots = board.getGroupSlots(board.getPlayerToMove()); slots;) {
+            const Bitboard128 libs = board.getGroup(popLSB(slots)).liberties;
+            if (bitCount(libs) == 1) {
+                escapes = inAtari ? escapes & libs : libs;
+                inAtari = true;
+            }
+        }
+        return escapes;
+    }
+
+    static bool canCapture(const Board &board) {
+        for (Bitboard128 slots = board.getGroupSlots(other(board.getPlayerToMove())); slots;) {
+            if (bitCount(board.getGroup(popLSB(slots)).liberties) == 1) return true;
+        }
+        return false;
+    }
+
+    // Claims and builds the children of `index`, `board` being its position. Returns false if another thread has
+    // claimed it or the pool is full. A position decided before any move gets no children, only an outcome.
+    bool expand(const uint32_t index, Board &board) {
+        Node &node = nodes()[index];
+        if (poolFull.load(std::memory_order_relaxed)) return false;
+        uint8_t expected = UNEXPANDED;
+        if (!node.expansion.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire)) return false;
+
+        // The same pruning as the solvers: a capture wins, and a group in atari must extend
+        int8_t outcome = 0;
+        std::array<int, BOARD_SIZE> moves{};
+        int moveCount = 0;
+        if (canCapture(board)) {
+            outcome = -1;
+        } else {
+            bool inAtari;
+            const Bitboard128 escapes = atariEscapes(board, inAtari);
+            Board::UndoRecord undo{};
+            for (Bitboard128 bits = inAtari ? escapes : ~board.getOccupiedBits() & FULL_BOARD_MASK; bits;) {
+                const int pos = popLSB(bits);
+                board.makeMove(pos, undo);
+                if (libertiesAfter(board, pos) > 0) moves[moveCount++] = pos; // Suicide loses at once
+                board.unmakeMove(undo);
+            }
+            if (!moveCount) outcome = 1;
+        }
+
+        if (moveCount) {
+            const uint32_t first = poolUsed.fetch_add(moveCount, std::memory_order_relaxed);
+            if (first + moveCount > poolCapacity) {
+                poolFull.store(true, std::memory_order_relaxed);
+                node.expansion.store(UNEXPANDED, std::memory_order_release);
+                return false;
+            }
+            for (int i = 0; i < moveCount; ++i) nodes()[first + i].reset(moves[i]);
+            node.firstChild = first;
+            node.childCount = static_cast<uint16_t>(moveCount);
+        }
+        node.outcome.store(outcome, std::memory_order_relaxed);
+        node.expansion.store(EXPANDED, std::memory_order_release);
+        return true;
+    }
+
+    // The child of `node` to descend into: UCT on the win rate blended with the RAVE win rate. Proven children decide
+    // the node, which is recorded on the way (returns NO_MOVE then).
+    uint32_t select(Node &node) const {
+        const double logVisits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed)) + 1.0);
+        double bestValue = -1;
+        uint32_t best = 0;
+        bool allLost = true;
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+            const Node &child = nodes()[i];
+            const int8_t outcome = child.outcome.load(std::memory_order_relaxed);
+            if (outcome > 0) {
+                node.outcome.store(-1, std::memory_order_relaxed);
+                return static_cast<uint32_t>(NO_MOVE);
+            }
+            if (outcome < 0) continue;
+            allLost = false;
+
+            const double virtualLoss = child.virtualLoss.load(std::memory_order_relaxed);
+            const double visits = child.visits.load(std::memory_order_relaxed) + virtualLoss;
+            const double raveVisits = child.raveVisits.load(std::memory_order_relaxed);
+            double value;
+            if (visits == 0 && raveVisits == 0) {
+                value = 1.0 + options.exploration; // First-play urgency: try every move once
+            } else {
+                const double winRate = visits > 0 ? child.wins.load(std::memory_order_relaxed) / visits : 0.0;
+                double beta = 0;
+                if (options.raveEquivalence > 0 && raveVisits > 0) {
+                    beta = raveVisits / (raveVisits + visits + visits * raveVisits / options.raveEquivalence);
+                }
+                const double raveRate = raveVisits > 0 ? child.raveWins.load(std::memory_order_relaxed) / raveVisits
+                                                       : 0.0;
+                value = (1 - beta) * winRate + beta * raveRate
+                        + options.exploration * std::sqrt(logVisits / (visits + 1));
+            }
+            if (value > bestValue) {
+                bestValue = value;
+                best = i;
+            }
+        }
+        if (allLost) {
+            node.outcome.store(1, std::memory_order_relaxed);
+            return static_cast<uint32_t>(NO_MOVE);
+        }
+        return best;
+    }
+
+    // One simulation: selection, expansion, playout and backpropagation with the all-moves-as-first updates
+    void simulate(Playout::Random &random, uint64_t &playoutMoves) {
+        Board board = rootBoard;
+        std::array<uint32_t, MAX_DEPTH> path{};
+        std::array<Bitboard128, MAX_DEPTH> stonesAt{}; // Occupied points at each node of the path
+        int depth = 0;
+        path[0] = ROOT;
+        stonesAt[0] = board.getOccupiedBits();
+
+        Board::UndoRecord undo{};
+        int8_t outcome = 0;
+        while (true) {
+            Node &node = nodes()[path[depth]];
+            if ((outcome = node.outcome.load(std::memory_order_relaxed))) break;
+            if (node.expansion.load(std::memory_order_acquire) != EXPANDED) {
+                const bool ready = depth == 0 || node.visits.load(std::memory_order_relaxed) >= options.expandVisits;
+                if (!ready || !expand(path[depth], board)) break;
+                if ((outcome = node.outcome.load(std::memory_order_relaxed))) break;
+            }
+            const uint32_t child = select(node);
+            if (child == static_cast<uint32_t>(NO_MOVE)) {
+                outcome = node.outcome.load(std::memory_order_relaxed);
+                break;
+            }
+            nodes()[child].virtualLoss.fetch_add(options.virtualLoss, std::memory_order_relaxed);
+            board.makeMove(nodes()[child].move, undo);
+            path[++depth] = child;
+            stonesAt[depth] = board.getOccupiedBits();
+        }
+
+        // The player who played the move of the last node on the path
+        const Player leafMover = other(board.getPlayerToMove());
+        Player winner;
+        Bitboard128 finalBlack = board.getBlackBits();
+        Bitboard128 finalWhite = board.getWhiteBits();
+        if (outcome) winner = outcome > 0 ? leafMover : other(leafMover);
+        else winner = Playout::run(board, options.playoutPolicy, random, finalBlack, finalWhite, playoutMoves);
+
+        // Each point is played at most once per game, so the moves played after a node are the stones it lacks
+        Player mover = leafMover;
+        for (int d = depth; d >= 0; --d, mover = other(mover)) {
+            Node &node = nodes()[path[d]];
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+            if (winner == mover) node.wins.fetch_add(1, std::memory_order_relaxed);
+            if (d > 0) node.virtualLoss.fetch_sub(options.virtualLoss, std::memory_order_relaxed);
+
+            if (options.raveEquivalence <= 0 || node.expansion.load(std::memory_order_acquire) != EXPANDED) continue;
+            // Children are moves of the player to move at this node, the opponent of `mover`
+            const Player toMove = other(mover);
+            const Bitboard128 playedLater = (toMove == BLACK ? finalBlack : finalWhite) & ~stonesAt[d];
+            if (!playedLater) continue;
+            const uint32_t won = winner == toMove;
+            for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+                Node &child = nodes()[i];
+                if (!testBit(playedLater, child.move)) continue;
+                child.raveVisits.fetch_add(1, std::memory_order_relaxed);
+                if (won) child.raveWins.fetch_add(won, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Finds the node of `target` below `index` by playing the stones it has and `board` lacks, in any order
+    bool findNode(const uint32_t index, const Board &board, const Board &target, uint32_t &found) const {
+        if (board.getTurn() == target.getTurn()) {
+            if (board.getSignature() != target.getSignature()) return false;
+            found = index;
+            return true;
+        }
+        const Node &node = nodes()[index];
+        if (node.expansion.load(std::memory_order_acquire) != EXPANDED) return false;
+        const bool black = board.getPlayerToMove() == BLACK;
+        const Bitboard128 wanted = (black ? target.getBlackBits() : target.getWhiteBits())
+                                   & ~(black ? board.getBlackBits() : board.getWhiteBits());
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+            if (!testBit(wanted, nodes()[i].move)) continue;
+            Board next = board;
+            next.setStone(nodes()[i].move);
+            if (findNode(i, next, target, found)) return true;
+        }
+        return false;
+    }
+
+    // Moves the subtree of `index` to the other half of the pool, its root at ROOT, and makes that half active
+    void keepSubtree(const uint32_t index) {
+        Node *from = nodes();
+        Node *to = pools[1 - activePool].get();
+        std::vector<std::pair<uint32_t, uint32_t>> queue{{index, ROOT}}; // (old index, new index)
+        uint32_t used = 1;
+        for (size_t q = 0; q < queue.size(); ++q) {
+            const auto [oldIndex, newIndex] = queue[q];
+            const Node &source = from[oldIndex];
+            Node &copy = to[newIndex];
+            copy.reset(source.move);
+            copy.visits.store(source.visits.load());
+            copy.wins.store(source.wins.load());
+            copy.raveVisits.store(source.raveVisits.load());
+            copy.raveWins.store(source.raveWins.load());
+            copy.outcome.store(source.outcome.load());
+            if (source.expansion.load() != EXPANDED) continue;
+            copy.expansion.store(EXPANDED);
+            copy.firstChild = used;
+            copy.childCount = source.childCount;
+            for (uint32_t i = 0; i < source.childCount; ++i) queue.emplace_back(source.firstChild + i, used + i);
+            used += source.childCount;
+        }
+        activePool = 1 - activePool;
+        poolUsed.store(used);
+        poolFull.store(false);
+    }
+
+    void resetTree(const Board &state) {
+        nodes()[ROOT].reset(NO_MOVE);
+        poolUsed.store(1);
+        poolFull.store(false);
+        rootBoard = state;
+        hasTree = true;
+    }
+
+public:
+    explicit MonteCarlo(const MonteCarloOptions &options = {}) : options(options) {
+        const size_t bytes = std::max<size_t>(options.poolSizeMb, 1) * 1024 * 1024;
+        poolCapacity = bytes / 2 / sizeof(Node);
+        pools[0] = std::make_unique<Node[]>(poolCapacity);
+        pools[1] = std::make_unique<Node[]>(poolCapacity);
+    }
+
+    /// Searches `state` until `timeLimit` or `simulationLimit` simulations and returns the position after the most
+    /// visited move. The tree left by the previous call is reused when it contains `state`.
+    Board getBestMove(const Board &state, const std::chrono::milliseconds timeLimit,
+                      const uint64_t simulationLimit = UINT64_MAX) {
+        const auto start = std::chrono::steady_clock::now();
+
+        uint32_t found = ROOT;
+        uint32_t reusedVisits = 0;
+        if (hasTree && findNode(ROOT, rootBoard, state, found)) {
+            keepSubtree(found);
+            rootBoard = state;
+            reusedVisits = nodes()[ROOT].visits.load();
+        } else {
+            resetTree(state);
+        }
+
+        std::atomic<uint64_t> simulations{0};
+        std::atomic<bool> stop{false};
+        auto work = [this, &simulations, &stop, start, timeLimit, simulationLimit](const uint64_t seed) {
+            Playout::Random random(seed);
+            uint64_t playoutMoves = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 16; ++i) simulate(random, playoutMoves);
+                const uint64_t done = simulations.fetch_add(16, std::memory_order_relaxed) + 16;
+                if (done >= simulationLimit || std::chrono::steady_clock::now() - start >= timeLimit
+                    || nodes()[ROOT].outcome.load(std::memory_order_relaxed)) {
+                    stop.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+        std::vector<std::thread> helpers;
+        for (int id = 1; id < options.threads; ++id) helpers.emplace_back(work, getRandom()());
+        work(getRandom()());
+        for (auto &helper: helpers) helper.join();
+
+        // A proven win first, then the most visited move not proven lost, then the most visited move
+        const Node &root = nodes()[ROOT];
+        int bestMove = NO_MOVE;
+        int bestRank = -1;
+        uint32_t bestVisits = 0, bestWins = 0;
+        for (uint32_t i = root.firstChild; i < root.firstChild + root.childCount; ++i) {
+            const Node &child = nodes()[i];
+            const uint32_t visits = child.visits.load();
+            const int rank = child.outcome.load() + 1;
+            if (rank > bestRank || (rank == bestRank && visits > bestVisits)) {
+                bestMove = child.move;
+                bestRank = rank;
+                bestVisits = visits;
+                bestWins = child.wins.load();
+            }
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "MCTS: " << simulations.load() << " simulations (" << reusedVisits << " reused). Nodes: "
+                << poolUsed.load() << (poolFull.load() ? " (pool full)" : "") << ". Best move: " << bestMove
+                << " with " << bestVisits << " visits, win rate " << (bestVisits ? 100.0 * bestWins / bestVisits : 0)
+                << "%. Time: " << elapsed << " ms\n";
+
+        Board result = state;
+        if (bestMove == NO_MOVE) {
+            // The root has no children when it is decided before any move: capture if possible, else the game is lost
+            bestMove = getLSBIndex(~state.getOccupiedBits() & FULL_BOARD_MASK);
+            for (Bitboard128 slots = state.getGroupSlots(other(state.getPlayerToMove())); slots;) {
+                const Bitboard128 libs = state.getGroup(popLSB(slots)).liberties;
+                if (bitCount(libs) == 1) bestMove = getLSBIndex(libs);
+            }
+        }
+        result.setStone(bestMove);
+        AtariGo::computeHeuristic(result);
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <algorithm>
+#include <array>
+
+#include "AtariGo.h"
+
+/// Hands out the moves of a position one at a time, in stages, so no ordering work is spent on moves that are never
+/// searched because an earlier one produced a cutoff:
+///   1. the hash move;
+///   2. tactical moves, found with bitboard tests on the group liberties: captures, atari escapes, then ataris;
+///   3. the killer moves of this ply (quiet moves that caused a cutoff in a sibling subtree);
+///   4. the remaining moves, ordered by history and a cheap score that is only computed once the moves above run out.
+class MovePicker {
+public:
+    // Largest value of a history entry (see MiniMax::SearchContext::updateQuietStats)
+    static constexpr int HISTORY_MAX = 1 << 14;
+    using History = std::array<int, BOARD_SIZE>;
+    using Killers = std::array<int, 2>;
+
+private:
+    enum Stage { HASH_MOVE, TACTICAL_INIT, TACTICAL, KILLERS, QUIET_INIT, QUIET, DONE };
+
+    const Board &state;
+    const int hashMove;
+    const Killers &killers;
+    const History &history; // History of the player to move
+    Stage stage = HASH_MOVE;
+    int killerIndex = 0;
+
+    Bitboard128 candidates; // Moves not handed out yet
+
+    // Tactical moves, in the order they are handed out
+    std::array<Bitboard128, 3> tactical{}; // Captures, atari escapes, ataris
+    Bitboard128 allTactical = 0; // Union of the above, kept intact while they are handed out
+    bool classified = false;
+
+    // Liberties of groups short of liberties, used to score quiet moves
+    Bitboard128 opponentThreeLibs = 0; // Playing here leaves an opponent group with 2 liberties
+    Bitboard128 opponentFourLibs = 0; // Playing here leaves an opponent group with 3 liberties
+    Bitboard128 ownTwoLibs = 0; // Playing here may keep an own group out of atari
+    Bitboard128 ownThreeLibs = 0; // Playing here keeps an own group at 3 liberties or more
+
+    MoveList quiets;
+    int quietIndex = 0;
+
+    // Handicap for the easy levels: drop AtariGo::removeRandomSuccessorsPercentage of the moves, keeping at least one
+    void removeRandomCandidates() {
+        std::array<int, BOARD_SIZE> positions{};
+        int count = 0;
+        for (Bitboard128 bits = candidates; bits;) positions[count++] = popLSB(bits);
+
+        int toRemove = static_cast<int>(count * (AtariGo::removeRandomSuccessorsPercentage / 100.0));
+        if (toRemove >= count) toRemove = count - 1;
+        if (toRemove <= 0) return;
+
+        std::shuffle(positions.begin(), positions.begin() + count, getRandom());
+        for (int i = 0; i < toRemove; ++i) clearBit(candidates, positions[i]);
+    }
+
+    void classifyGroups() {
+        classified = true;
+        const Player toMove = state.getPlayerToMove();
+        const Player opponent = toMove == BLACK ? WHITE : BLACK;
+
+        for (Bitboard128 slots = state.getGroupSlots(opponent); slots;) {
+            const Bitboard128 libs = state.getGroup(popLSB(slots)).liberties;
+            switch (bitCount(libs)) {
+                case 1: tactical[0] |= libs; break; // Capture
+                case 2: tactical[2] |= libs; break; // Atari
+                case 3: opponentThreeLibs |= libs; break;
+                case 4: opponentFourLibs |= libs; break;
+                default: break;
+            }
+        }
+
+        for (Bitboard128 slots = state.getGroupSlots(toMove); slots;) {
+            const Bitboard128 libs = state.getGroup(popLSB(slots)).liberties;
+            switch (bitCount(libs)) {
+                case 1: tactical[1] |= libs; break; // Escape
+                case 2: ownTwoLibs |= libs; break;
+                case 3: ownThreeLibs |= libs; break;
+                default: break;
+            }
+        }
+
+        allTactical = tactical[0] | tactical[1] | tactical[2];
+    }
+
+    // History first, then a cheap stand-in for the heuristic of the resulting position: pressure on weak opponent
+    // groups, support for weak own groups and room for the new stone. Self-ataris of a lone stone go last.
+    void scoreQuiets() {
+        const Bitboard128 own = state.getPlayerToMove() == BLACK ? state.getBlackBits() : state.getWhiteBits();
+        const Bitboard128 empty = ~state.getOccupiedBits() & FULL_BOARD_MASK;
+
+        quiets.size = 0;
+        for (Bitboard128 bits = candidates; bits;) {
+            const int pos = popLSB(bits);
+            const Bitboard128 neighbours = getNeighbourBits(ONE_BIT << pos);
+            const int emptyNeighbours = bitCount(neighbours & empty);
+
+            int score = 4 * emptyNeighbours;
+            if (testBit(opponentThreeLibs, pos)) score += 12;
+            else if (testBit(opponentFourLibs, pos)) score += 6;
+            if (testBit(ownTwoLibs, pos)) score += 10;
+            else if (testBit(ownThreeLibs, pos)) score += 4;
+            if (emptyNeighbours <= 1 && !(neighbours & own)) score -= 16;
+            score = score * HISTORY_MAX / 1024 + history[pos]; // The cheap score mostly breaks ties
+
+            quiets.moves[quiets.size++] = {pos, score};
+        }
+    }
+
+public:
+    MovePicker(const Board &state, const int hashMove, const Killers &killers, const History &history)
+        : state(state), hashMove(hashMove), killers(killers), history(history) {
+        candidates = getNeighbourBits(state.getOccupiedBits());
+        if (AtariGo::removeRandomSuccessorsPercentage > 0) removeRandomCandidates();
+    }
+
+    /// Returns the next move to search, or NO_MOVE once every move was handed out.
+    int next() {
+        switch (stage) {
+            case HASH_MOVE:
+                stage = TACTICAL_INIT;
+                if (hashMove != NO_MOVE && testBit(candidates, hashMove)) {
+                    clearBit(candidates, hashMove);
+                    return hashMove;
+                }
+                [[fallthrough]];
+
+            case TACTICAL_INIT:
+                if (!classified) classifyGroups();
+                stage = TACTICAL;
+                [[fallthrough]];
+
+            case TACTICAL:
+                for (Bitboard128 &moves: tactical) {
+                    moves &= candidates;
+                    if (moves) {
+                        const int pos = popLSB(moves);
+                        clearBit(candidates, pos);
+                        return pos;
+                    }
+                }
+                stage = KILLERS;
+                [[fallthrough]];
+
+            case KILLERS:
+                while (killerIndex < static_cast<int>(killers.size())) {
+                    const int killer = killers[killerIndex++];
+                    if (killer != NO_MOVE && testBit(candidates, killer)) {
+                        clearBit(candidates, killer);
+                        return killer;
+                    }
+                }
+                stage = QUIET_INIT;
+                [[fallthrough]];
+
+            case QUIET_INIT:
+                scoreQuiets();
+                stage = QUIET;
+                [[fallthrough]];
+
+            case QUIET:
+                if (quietIndex < quiets.size) {
+                    // Selection sort, one step per call: only the moves actually searched get sorted
+                    ScoredMove *best = std::max_element(quiets.begin() + quietIndex, quiets.end(),
+                                                        [](const ScoredMove &a, const ScoredMove &b) {
+                                                            return a.score < b.score;
+                                                        });
+                    std::swap(*best, quiets.moves[quietIndex]);
+                    return quiets.moves[quietIndex++].pos;
+                }
+                stage = DONE;
+                [[fallthrough]];
+
+            case DONE:
+                break;
+        }
+        return NO_MOVE;
+    }
+
+    /// True if `pos` is neither a capture, an atari escape nor an atari. Only quiet moves feed killers and history.
+    [[nodiscard]] bool isQuiet(const int pos) {
+        if (!classified) classifyGroups();
+        return !testBit(allTactical, pos);
+    }
+};
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "BBUtils.h"
+#include "Board.h"
+
+/// Random playouts to the first capture, played on two raw bitboards. No group table, heuristic or allocation: each
+/// move only looks at the groups it touches, which is all a capture or a suicide can come from.
+///
+/// Two policies:
+///   - UNIFORM: every empty point is equally likely, suicide included (it ends the game like any other capture);
+///   - LIGHT: capture the group the last move left in atari, else extend a group the last move put in atari, else a
+///     random point that is neither suicide nor self-atari. Every rule looks at the last move only.
+class Playout {
+public:
+    enum Policy { UNIFORM, LIGHT };
+
+    // Xorshift generator: playouts draw millions of numbers and need no statistical finesse
+    struct Random {
+        uint64_t state;
+
+        explicit Random(const uint64_t seed) : state(seed | 1) {
+        }
+
+        // Uniform in [0, n)
+        uint32_t below(const uint32_t n) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return static_cast<uint32_t>(((state >> 32) * n) >> 32);
+        }
+    };
+
+    struct Stats {
+        uint64_t playouts = 0;
+        uint64_t blackWins = 0;
+        uint64_t moves = 0; // Moves played over all playouts, the capture included
+
+        [[nodiscard]] double winRate(const Player player) const {
+            if (!playouts) return 0.5;
+            const double black = static_cast<double>(blackWins) / static_cast<double>(playouts);
+            return player == BLACK ? black : 1 - black;
+        }
+    };
+
+private:
+    // Neighbours of each point, cheaper to look up than to shift a single stone in every direction
+    static constexpr std::array<Bitboard128, BOARD_SIZE> NEIGHBOURS = [] {
+        std::array<Bitboard128, BOARD_SIZE> table{};
+        for (int pos = 0; pos < BOARD_SIZE; ++pos) {
+            const int row = pos / BOARD_EDGE, col = pos % BOARD_EDGE;
+            if (row > 0) table[pos] |= ONE_BIT << (pos - BOARD_EDGE);
+            if (row < BOARD_EDGE - 1) table[pos] |= ONE_BIT << (pos + BOARD_EDGE);
+            if (col > 0) table[pos] |= ONE_BIT << (pos - 1);
+            if (col < BOARD_EDGE - 1) table[pos] |= ONE_BIT << (pos + 1);
+        }
+        return table;
+    }();
+
+    static bool single(const Bitboard128 bits) { return bits && !(bits & (bits - 1)); }
+
+    // A random point of `candidates`, which must not be empty. Sampling the whole board first is cheaper than
+    // indexing the set bits while the board is mostly empty.
+    static int randomPoint(const Bitboard128 candidates, Random &random) {
+        for (int tries = 0; tries < 4; ++tries) {
+            const int pos = static_cast<int>(random.below(BOARD_SIZE));
+            if (testBit(candidates, pos)) return pos;
+        }
+        uint32_t n = random.below(bitCount(candidates));
+        auto lo = static_cast<uint64_t>(candidates);
+        auto hi = static_cast<uint64_t>(candidates >> 64);
+        const auto loCount = static_cast<uint32_t>(bitCount(lo));
+        if (n >= loCount) {
+            n -= loCount;
+            lo = hi;
+            while (n--) lo &= lo - 1;
+            return getLSBIndex(lo) + 64;
+        }
+        while (n--) lo &= lo - 1;
+        return getLSBIndex(lo);
+    }
+
+    // Liberties of the group of `seed` among `stones`, filling the group only until two liberties are found: the result
+    // is exact up to one liberty, and some of them past that. `group` gets the stones filled.
+    static Bitboard128 liberties(const Bitboard128 stones, const Bitboard128 seed, const Bitboard128 empty,
+                                 Bitboard128 &group) {
+        group = seed;
+        while (true) {
+            const Bitboard128 neighbours = getNeighbourBits(group);
+            const Bitboard128 libs = neighbours & empty;
+            const Bitboard128 added = neighbours & stones;
+            if (!added || (libs && !single(libs))) return libs;
+            group |= added;
+        }
+    }
+
+    enum MoveResult { CAPTURES, SUICIDE, ATARI_ON_SELF, QUIET };
+
+    // Places `stone` for the owner of `own` and reads the groups around it. `ownLibs` gets the liberties of the new
+    // stone's group; `ataris` gets the last liberty of every opponent group the stone left in atari.
+    static MoveResult place(const int pos, Bitboard128 &own, const Bitboard128 opp, Bitboard128 &ownLibs,
+                            Bitboard128 &ataris) {
+        const Bitboard128 stone = ONE_BIT << pos;
+        own |= stone;
+        const Bitboard128 empty = ~(own | opp) & FULL_BOARD_MASK;
+        ataris = 0;
+        for (Bitboard128 adjacent = NEIGHBOURS[pos] & opp; adjacent;) {
+            const int neighbour = getLSBIndex(adjacent);
+            // A stone with two liberties of its own keeps its group out of atari, no need to fill the group
+            const Bitboard128 neighbourLibs = NEIGHBOURS[neighbour] & empty;
+            if (neighbourLibs && !single(neighbourLibs)) {
+                clearLSB(adjacent);
+                continue;
+            }
+            Bitboard128 group;
+            const Bitboard128 libs = liberties(opp, ONE_BIT << neighbour, empty, group);
+            if (!libs) return CAPTURES;
+            if (single(libs)) ataris |= libs;
+            adjacent &= ~group;
+        }
+        ownLibs = NEIGHBOURS[pos] & empty;
+        if (!ownLibs || single(ownLibs)) {
+            Bitboard128 group;
+            ownLibs = liberties(own, stone, empty, group);
+        }
+        if (!ownLibs) return SUICIDE;
+        return single(ownLibs) ? ATARI_ON_SELF : QUIET;
+    }
+
+public:
+    /// Plays from `black` and `white` with `toMove` to move until the first capture and returns the winner. The
+    /// bitboards are left holding the final stones, the winning move included. `captures` holds the points where
+    /// `toMove` captures at once and `escapes` those that save a `toMove` group in atari; only LIGHT reads them.
+    static Player run(Bitboard128 &black, Bitboard128 &white, Player toMove, Bitboard128 captures,
+                      Bitboard128 escapes, const Policy policy, Random &random, uint64_t &moves) {
+        // Kept in registers rather than behind references, and swapped every move
+        Bitboard128 own = toMove == BLACK ? black : white;
+        Bitboard128 opp = toMove == BLACK ? white : black;
+        Player mover = toMove;
+        auto finish = [&](const Player winner) {
+            black = mover == BLACK ? own : opp;
+            white = mover == BLACK ? opp : own;
+            return winner;
+        };
+
+        while (true) {
+            const Player other = mover == BLACK ? WHITE : BLACK;
+            const Bitboard128 empty = ~(own | opp) & FULL_BOARD_MASK;
+            if (!empty) return finish(other); // Unreachable: filling the last point captures or is suicide
+
+            Bitboard128 ownLibs = 0, ataris = 0;
+            MoveResult result;
+            if (policy == UNIFORM) {
+                result = place(randomPoint(empty, random), own, opp, ownLibs, ataris);
+            } else if (captures) {
+                own |= captures & -captures;
+                result = CAPTURES;
+            } else if (escapes) {
+                result = place(getLSBIndex(escapes), own, opp, ownLibs, ataris);
+            } else {
+                Bitboard128 candidates = empty;
+                while (true) {
+                    const int pos = randomPoint(candidates, random);
+                    const Bitboard128 stone = ONE_BIT << pos;
+                    result = place(pos, own, opp, ownLibs, ataris);
+                    candidates &= ~stone;
+                    // Suicide and self-atari lose; play them only when nothing else is left
+                    if ((result != SUICIDE && result != ATARI_ON_SELF) || !candidates) break;
+                    own &= ~stone;
+                }
+            }
+            ++moves;
+
+            if (result == CAPTURES) return finish(mover);
+            if (result == SUICIDE) return finish(other);
+            captures = result == ATARI_ON_SELF ? ownLibs : 0; // The opponent captures the group that is now in atari
+            escapes = ataris;
+            std::swap(own, opp);
+            mover = other;
+        }
+    }
+
+    /// Plays one game out from `state`, which must not be decided yet, and returns the winner. `black` and `white`
+    /// get the final stones.
+    static Player run(const Board &state, const Policy policy, Random &random, Bitboard128 &black, Bitboard128 &white,
+                      uint64_t &moves) {
+        const Player toMove = state.getPlayerToMove();
+        const Player opponent = toMove == BLACK ? WHITE : BLACK;
+        Bitboard128 captures = 0, escapes = 0;
+        for (Bitboard128 slots = state.getGroupSlots(opponent); slots;) {
+            const Bitboard128 libs = state.getGroup(popLSB(slots)).liberties;
+            if (single(libs)) captures |= libs;
+        }
+        for (Bitboard128 slots = state.getGroupSlots(toMove); slots;) {
+            const Bitboard128 libs = state.getGroup(popLSB(slots)).liberties;
+            if (single(libs)) escapes |= libs;
+        }
+        black = state.getBlackBits();
+        white = state.getWhiteBits();
+        return run(black, white, toMove, captures, escapes, policy, random, moves);
+    }
+
+    /// Win statistics of `playouts` games played out from `state`, for quick assessments and leaf evaluation.
+    [[nodiscard]] static Stats evaluate(const Board &state, const uint64_t playouts, const Policy policy,
+                                        Random &random) {
+        Stats stats;
+        for (uint64_t i = 0; i < playouts; ++i) {
+            Bitboard128 black, white;
+            if (run(state, policy, random, black, white, stats.moves) == BLACK) ++stats.blackWins;
+        }
+        stats.playouts = playouts;
+        return stats;
+    }
+};
+
+#endif
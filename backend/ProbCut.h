@@ -0,0 +1,42 @@
+#ifndef PROBCUT_H
+#define PROBCUT_H
+
+#include <array>
+
+#include "Globals.h"
+
+/// ProbCut: the score of a deep search is predicted from the score of a shallow one by a linear model,
+/// deep ~ slope * shallow + intercept, whose error has standard deviation sigma. A node whose shallow search lands far
+/// enough outside the window (threshold * sigma, see SearchOptions::probCutThreshold) is pruned without the deep
+/// search. The models are fitted offline on self-play positions by calibrate_probcut, which writes
+/// ProbCutCalibration.h.
+struct ProbCutModel {
+    int depth; // Depth of the deep search; the shallow one is depth - PROBCUT_REDUCTION
+    double slope;
+    double intercept;
+    double sigma;
+    int samples; // Score pairs the model was fitted on
+};
+
+#include "ProbCutCalibration.h"
+
+class ProbCut {
+public:
+    static constexpr int REDUCTION = PROBCUT_REDUCTION;
+
+    // Scores this large are tactical (ataris, wins): the models are fitted without them and never applied to them
+    static constexpr int MAX_SCORE = ATARI_THREAT_SCORE / 2;
+
+    /// The model for a node searched to `depth`: the deepest calibrated one past the last calibrated depth, none before
+    /// the first one, or for another board size than the calibration's.
+    [[nodiscard]] static const ProbCutModel *model(const int depth) {
+        if (PROBCUT_BOARD_EDGE != BOARD_EDGE || PROBCUT_MODELS.empty() || depth < PROBCUT_MODELS.front().depth)
+            return nullptr;
+        for (const ProbCutModel &m: PROBCUT_MODELS) {
+            if (m.depth == depth) return &m;
+        }
+        return &PROBCUT_MODELS.back();
+    }
+};
+
+#endif
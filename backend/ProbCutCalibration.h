@@ -0,0 +1,18 @@
+// Generated by calibrate_probcut, do not edit. Included by ProbCut.h.
+// 60 self-play games, 1681 positions, 100 ms per move.
+#ifndef PROBCUTCALIBRATION_H
+#define PROBCUTCALIBRATION_H
+
+constexpr int PROBCUT_BOARD_EDGE = 9;
+constexpr int PROBCUT_REDUCTION = 4;
+
+inline constexpr std::array<ProbCutModel, 6> PROBCUT_MODELS = {{
+    {5, 0.502497, -31.6174, 1446.85, 1176},
+    {6, 0.698814, -48.0765, 1195.4, 1146},
+    {7, 0.735849, -115.023, 1418.38, 1114},
+    {8, 0.825291, 10.1626, 1202.9, 1078},
+    {9, 0.869211, -44.3377, 1315.72, 1041},
+    {10, 0.875384, 44.8341, 1137.03, 995},
+}};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/// Decides, between two iterations of the iterative deepening, whether the next depth is worth starting.
+/// The time limit given to getBestMove is the hard limit: the search is aborted there and the unfinished iteration is
+/// lost. To waste as little as possible on such iterations, the manager stops earlier:
+///   - at the soft limit, a fraction of the hard one, scaled by how stable the best move is: a move that survived
+///     several depths stops the search sooner, a move that just changed gets extra time;
+///   - when the next depth is predicted to end past the hard limit, from the growth of the previous iterations.
+class TimeManager {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Decision { CONTINUE, STOP_SOFT_LIMIT, STOP_PREDICTED_OVERRUN };
+
+private:
+    // Share of the hard limit the search aims to use when the best move is neither stable nor unstable
+    static constexpr double SOFT_LIMIT_FRACTION = 0.5;
+    // Soft limit scale: +50% right after the best move changed, -10% per depth it stayed the same, down to 40%
+    static constexpr double UNSTABLE_SCALE = 1.5;
+    static constexpr double STABILITY_STEP = 0.1;
+    static constexpr double MIN_STABLE_SCALE = 0.4;
+    // Bounds of the predicted growth of one iteration to the next. The lower bound keeps a cheap, TT-assisted
+    // iteration from making the next one look free.
+    static constexpr double MIN_GROWTH = 1.5;
+    static constexpr double MAX_GROWTH = 8.0;
+
+    const Clock::time_point start;
+    const std::chrono::microseconds hardLimit;
+    Clock::time_point lastIterationEnd;
+    std::chrono::microseconds lastIterationTime{0};
+    std::chrono::microseconds previousIterationTime{0};
+    uint64_t bestMove = 0; // Any identifier of the best move, only compared for equality
+    int iterations = 0;
+    int stableIterations = 0; // Completed iterations in a row that kept the best move
+    bool bestMoveChanged = false;
+
+    [[nodiscard]] double stabilityScale() const {
+        if (bestMoveChanged) return UNSTABLE_SCALE;
+        return std::max(MIN_STABLE_SCALE, 1.0 - STABILITY_STEP * stableIterations);
+    }
+
+public:
+    TimeManager(const Clock::time_point start, const std::chrono::milliseconds hardLimit)
+        : start(start), hardLimit(hardLimit), lastIterationEnd(start) {
+    }
+
+    /// Records a completed iteration and the move it found best.
+    void iterationCompleted(const uint64_t move) {
+        const Clock::time_point now = Clock::now();
+        previousIterationTime = lastIterationTime;
+        lastIterationTime = std::chrono::duration_cast<std::chrono::microseconds>(now - lastIterationEnd);
+        lastIterationEnd = now;
+
+        bestMoveChanged = iterations > 0 && move != bestMove;
+        stableIterations = iterations > 0 && !bestMoveChanged ? stableIterations + 1 : 0;
+        bestMove = move;
+        ++iterations;
+    }
+
+    /// Whether to search one depth more, to be asked after iterationCompleted.
+    [[nodiscard]] Decision nextIteration() const {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+        if (elapsed.count() >= hardLimit.count() * SOFT_LIMIT_FRACTION * stabilityScale()) return STOP_SOFT_LIMIT;
+
+        // Iterations too short to time tell nothing about the next one
+        if (previousIterationTime.count() > 1000) {
+            const double growth = std::clamp(static_cast<double>(lastIterationTime.count())
+                                             / static_cast<double>(previousIterationTime.count()),
+                                             MIN_GROWTH, MAX_GROWTH);
+            if (elapsed.count() + lastIterationTime.count() * growth > hardLimit.count())
+                return STOP_PREDICTED_OVERRUN;
+        }
+        return CONTINUE;
+    }
+
+    [[nodiscard]] int getStableIterations() const { return stableIterations; }
+};
+
+#endif
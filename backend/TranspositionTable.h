@@ -0,0 +1,176 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Globals.h"
+
+// Default table size. The WASM heap is much smaller than a native process, so the web builds get a smaller table.
+#ifdef __EMSCRIPTEN__
+constexpr size_t DEFAULT_TT_SIZE_MB = 32;
+#else
+constexpr size_t DEFAULT_TT_SIZE_MB = 128;
+#endif
+
+/// Fixed-size transposition table.
+/// The table is allocated once, in megabytes, and never grows during a search. It is made of buckets of
+/// BUCKET_ENTRIES packed entries, each bucket exactly one cache line, so a probe costs a single cache miss.
+/// The table is shared by all search threads without any locking (see Entry).
+class TranspositionTable {
+public:
+    // What a successful probe returns
+    struct Data {
+        int score;
+        int depth;
+        Bound bound;
+        int move;
+    };
+
+private:
+    // 16 bytes, written and read without locks by every search thread. `data` packs the score, depth, best move and
+    // (generation << 2 | bound + 1); `keyXorData` holds key ^ data. A torn write from two threads storing at the same
+    // time leaves a pair whose XOR no longer matches the key, so the probe rejects it instead of returning garbage.
+    // A zero in the bound bits marks an empty slot, so a zeroed table is an empty table.
+    struct Entry {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    static constexpr int BUCKET_ENTRIES = 4;
+    static constexpr uint8_t BOUND_MASK = 0b11;
+    static constexpr uint8_t GENERATION_MASK = 0b111111;
+    static constexpr uint8_t NO_MOVE_STORED = 0xFF;
+
+    struct alignas(64) Bucket {
+        Entry entries[BUCKET_ENTRIES];
+    };
+
+    static_assert(sizeof(Entry) == 16, "TT entries must stay packed");
+    static_assert(sizeof(Bucket) == 64, "A TT bucket must be exactly one cache line");
+    static_assert(BOARD_SIZE < NO_MOVE_STORED, "Board positions must fit in a TT entry");
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint64_t bucketMask = 0;
+    uint8_t generation = 0;
+
+    static constexpr uint64_t pack(const int score, const int depth, const int move, const uint8_t genBound) {
+        return static_cast<uint64_t>(static_cast<uint32_t>(score))
+               | static_cast<uint64_t>(static_cast<uint16_t>(depth)) << 32
+               | static_cast<uint64_t>(move == NO_MOVE ? NO_MOVE_STORED : static_cast<uint8_t>(move)) << 48
+               | static_cast<uint64_t>(genBound) << 56;
+    }
+
+    static constexpr int scoreOf(const uint64_t data) { return static_cast<int32_t>(static_cast<uint32_t>(data)); }
+    static constexpr int depthOf(const uint64_t data) { return static_cast<int16_t>(static_cast<uint16_t>(data >> 32)); }
+    static constexpr int moveOf(const uint64_t data) {
+        const auto move = static_cast<uint8_t>(data >> 48);
+        return move == NO_MOVE_STORED ? NO_MOVE : move;
+    }
+    static constexpr uint8_t genBoundOf(const uint64_t data) { return static_cast<uint8_t>(data >> 56); }
+
+    [[nodiscard]] Bucket &bucketFor(const uint64_t key) const { return buckets[key & bucketMask]; }
+
+    [[nodiscard]] static bool isEmpty(const uint64_t data) { return (genBoundOf(data) & BOUND_MASK) == 0; }
+
+    // How many searches ago this entry was written
+    [[nodiscard]] int age(const uint64_t data) const {
+        return (generation - (genBoundOf(data) >> 2)) & GENERATION_MASK;
+    }
+
+    // Lower is a better victim: shallow and old entries go first
+    [[nodiscard]] int replacementWorth(const uint64_t data) const { return depthOf(data) - 8 * age(data); }
+
+public:
+    explicit TranspositionTable(const size_t megabytes = DEFAULT_TT_SIZE_MB) { resize(megabytes); }
+
+    /// Reallocates the table to the largest power-of-two bucket count that fits in `megabytes`. Clears all entries.
+    /// Must not be called while a search is running.
+    void resize(const size_t megabytes) {
+        const size_t bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= bytes) count *= 2;
+
+        buckets.reset(); // Release the old table before allocating the new one
+        buckets = std::make_unique<Bucket[]>(count);
+        bucketCount = count;
+        bucketMask = count - 1;
+        clear();
+    }
+
+    /// Must not be called while a search is running.
+    void clear() {
+        for (size_t i = 0; i < bucketCount; ++i) {
+            for (Entry &e: buckets[i].entries) {
+                e.keyXorData.store(0, std::memory_order_relaxed);
+                e.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        generation = 0;
+    }
+
+    /// Starts a new search: entries written before this call age and become preferred replacement victims.
+    /// Must not be called while a search is running.
+    void newSearch() { generation = (generation + 1) & GENERATION_MASK; }
+
+    [[nodiscard]] bool probe(const uint64_t key, Data &out) const {
+        for (const Entry &e: bucketFor(key).entries) {
+            const uint64_t data = e.data.load(std::memory_order_relaxed);
+            if ((e.keyXorData.load(std::memory_order_relaxed) ^ data) != key || isEmpty(data)) continue;
+            out.score = scoreOf(data);
+            out.depth = depthOf(data);
+            out.bound = static_cast<Bound>((genBoundOf(data) & BOUND_MASK) - 1);
+            out.move = moveOf(data);
+            return true;
+        }
+        return false;
+    }
+
+    void store(const uint64_t key, const int score, const int depth, const Bound bound, int move = NO_MOVE) {
+        Bucket &bucket = bucketFor(key);
+
+        // Same position already stored: overwrite it. Otherwise, evict the least valuable entry of the bucket.
+        Entry *victim = &bucket.entries[0];
+        uint64_t victimData = victim->data.load(std::memory_order_relaxed);
+        bool sameKey = false;
+        for (Entry &e: bucket.entries) {
+            const uint64_t data = e.data.load(std::memory_order_relaxed);
+            sameKey = (e.keyXorData.load(std::memory_order_relaxed) ^ data) == key && !isEmpty(data);
+            if (sameKey || isEmpty(data)) {
+                victim = &e;
+                victimData = data;
+                break;
+            }
+            if (replacementWorth(data) < replacementWorth(victimData)) {
+                victim = &e;
+                victimData = data;
+            }
+        }
+
+        // Keep the old best move when the new result has none
+        if (move == NO_MOVE && sameKey) move = moveOf(victimData);
+
+        const uint64_t data = pack(score, depth, move, static_cast<uint8_t>(generation << 2 | (bound + 1)));
+        victim->keyXorData.store(key ^ data, std::memory_order_relaxed);
+        victim->data.store(data, std::memory_order_relaxed);
+    }
+
+    /// Permille of a sample of the table filled during the current search.
+    [[nodiscard]] int hashfull() const {
+        const size_t sample = bucketCount < 250 ? bucketCount : 250;
+        int used = 0;
+        for (size_t i = 0; i < sample; ++i) {
+            for (const Entry &e: buckets[i].entries) {
+                const uint64_t data = e.data.load(std::memory_order_relaxed);
+                if (!isEmpty(data) && age(data) == 0) ++used;
+            }
+        }
+        return static_cast<int>(used * 1000 / (sample * BUCKET_ENTRIES));
+    }
+
+    [[nodiscard]] size_t sizeInMegabytes() const { return bucketCount * sizeof(Bucket) / (1024 * 1024); }
+};
+
+#endif
@@ -0,0 +1,174 @@
+// Fits the ProbCut models (see ProbCut.h) and writes them to ProbCutCalibration.h.
+//
+// Usage: calibrate_probcut [--games N] [--max-depth D] [--reduction R] [--move-time MS] [--output FILE]
+//
+// Positions come from self-play: a few random opening stones, then MiniMax moves. Every position is searched to each
+// depth from 1 to D with ProbCut off and an empty transposition table, and the pairs (depth - R, depth) of
+// non-tactical scores are fitted by least squares, one model per deep depth.
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AtariGo.h"
+#include "Globals.h"
+#include "MiniMax.cpp"
+
+namespace {
+    constexpr int RANDOM_OPENING_PLIES = 4;
+    constexpr int MIN_SAMPLES = 30;
+
+    struct Fit {
+        double slope = 1, intercept = 0, sigma = 0;
+        int samples = 0;
+    };
+
+    Fit fitLine(const std::vector<std::pair<int, int> > &pairs) {
+        Fit fit;
+        fit.samples = static_cast<int>(pairs.size());
+        if (pairs.empty()) return fit;
+        double meanX = 0, meanY = 0;
+        for (const auto &[x, y]: pairs) {
+            meanX += x;
+            meanY += y;
+        }
+        meanX /= fit.samples;
+        meanY /= fit.samples;
+        double covariance = 0, varianceX = 0;
+        for (const auto &[x, y]: pairs) {
+            covariance += (x - meanX) * (y - meanY);
+            varianceX += (x - meanX) * (x - meanX);
+        }
+        if (varianceX > 0) fit.slope = covariance / varianceX;
+        fit.intercept = meanY - fit.slope * meanX;
+        double squares = 0;
+        for (const auto &[x, y]: pairs) {
+            const double error = y - (fit.slope * x + fit.intercept);
+            squares += error * error;
+        }
+        fit.sigma = std::sqrt(squares / fit.samples);
+        return fit;
+    }
+
+    // Plays one self-play game and returns its non-terminal positions
+    std::vector<Board> selfPlay(MiniMax &engine, const std::chrono::milliseconds moveTime) {
+        std::vector<Board> positions;
+        Board board;
+        board.setStone(3, 5);
+        board.setStone(3, 4);
+        board.setStone(4, 4);
+        board.setStone(4, 5);
+        AtariGo::computeHeuristic(board);
+
+        for (int ply = 0; !AtariGo::isTerminal(board); ++ply) {
+            positions.push_back(board);
+            // Random opening stones away from the others, so the games do not start with a tactical fight
+            const Bitboard128 quiet = ~(board.getOccupiedBits() | getNeighbourBits(board.getOccupiedBits()))
+                                      & FULL_BOARD_MASK;
+            if (ply < RANDOM_OPENING_PLIES && quiet) {
+                Bitboard128 bits = quiet;
+                for (int skip = std::uniform_int_distribution<int>(0, bitCount(quiet) - 1)(getRandom()); skip > 0;
+                     --skip) {
+                    clearLSB(bits);
+                }
+                board.setStone(getLSBIndex(bits));
+                AtariGo::computeHeuristic(board);
+            } else {
+                board = engine.getBestMove(board, moveTime, 64);
+            }
+        }
+        return positions;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int games = 20;
+    int maxDepth = 9;
+    int reduction = PROBCUT_REDUCTION;
+    int moveTimeMs = 100;
+    std::string output = "ProbCutCalibration.h";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--games" && i + 1 < argc) games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--max-depth" && i + 1 < argc) maxDepth = std::max(2, std::atoi(argv[++i]));
+        else if (arg == "--reduction" && i + 1 < argc) reduction = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--move-time" && i + 1 < argc) moveTimeMs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--output" && i + 1 < argc) output = argv[++i];
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (reduction >= maxDepth) {
+        std::cerr << "The reduction must be smaller than the maximum depth.\n";
+        return 1;
+    }
+
+    // The engine being calibrated must not prune with the models it is fitting
+    SearchOptions options;
+    options.probCut = false;
+    MiniMax engine(options);
+
+    // The searches log every move; only the calibration output matters here
+    std::ostringstream discarded;
+    std::streambuf *console = std::cout.rdbuf(discarded.rdbuf());
+
+    std::vector<Board> positions;
+    for (int game = 0; game < games; ++game) {
+        engine.clearTranspositionTable();
+        const std::vector<Board> gamePositions = selfPlay(engine, std::chrono::milliseconds(moveTimeMs));
+        positions.insert(positions.end(), gamePositions.begin(), gamePositions.end());
+        discarded.str("");
+        std::cerr << "Game " << game + 1 << "/" << games << ": " << gamePositions.size() << " positions\n";
+    }
+
+    // pairs[depth] holds the (shallow, deep) scores for the deep depth `depth`
+    std::vector<std::vector<std::pair<int, int> > > pairs(maxDepth + 1);
+    for (size_t p = 0; p < positions.size(); ++p) {
+        engine.clearTranspositionTable();
+        std::vector<int> scores(maxDepth + 1);
+        for (int depth = 1; depth <= maxDepth; ++depth) scores[depth] = engine.searchScore(positions[p], depth);
+        discarded.str("");
+        for (int depth = reduction + 1; depth <= maxDepth; ++depth) {
+            const int shallow = scores[depth - reduction], deep = scores[depth];
+            if (std::abs(shallow) < ProbCut::MAX_SCORE && std::abs(deep) < ProbCut::MAX_SCORE)
+                pairs[depth].emplace_back(shallow, deep);
+        }
+        if ((p + 1) % 50 == 0) std::cerr << "Searched " << p + 1 << "/" << positions.size() << " positions\n";
+    }
+    std::cout.rdbuf(console);
+
+    std::ostringstream models;
+    int modelCount = 0;
+    for (int depth = reduction + 1; depth <= maxDepth; ++depth) {
+        const Fit fit = fitLine(pairs[depth]);
+        std::cerr << "Depth " << depth << ": deep = " << fit.slope << " * shallow + " << fit.intercept << ", sigma "
+                << fit.sigma << ", " << fit.samples << " samples\n";
+        // A model needs enough data, and a positive slope to be inverted
+        if (fit.samples < MIN_SAMPLES || fit.slope <= 0.1) continue;
+        models << "    {" << depth << ", " << fit.slope << ", " << fit.intercept << ", " << fit.sigma << ", "
+                << fit.samples << "},\n";
+        ++modelCount;
+    }
+
+    std::ofstream file(output);
+    file << "// Generated by calibrate_probcut, do not edit. Included by ProbCut.h.\n"
+            << "// " << games << " self-play games, " << positions.size() << " positions, " << moveTimeMs
+            << " ms per move.\n"
+            << "#ifndef PROBCUTCALIBRATION_H\n#define PROBCUTCALIBRATION_H\n\n"
+            << "constexpr int PROBCUT_BOARD_EDGE = " << BOARD_EDGE << ";\n"
+            << "constexpr int PROBCUT_REDUCTION = " << reduction << ";\n\n"
+            << "inline constexpr std::array<ProbCutModel, " << modelCount << "> PROBCUT_MODELS = {{\n"
+            << models.str() << "}};\n\n#endif\n";
+    if (!file) {
+        std::cerr << "Could not write " << output << "\n";
+        return 1;
+    }
+    std::cerr << "Wrote " << modelCount << " models to " << output << "\n";
+    return 0;
+}
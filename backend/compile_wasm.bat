@@ -15,9 +15,10 @@ call em++ -std=c++17 -O3 -flto -ffast-math -msimd128 -funroll-loops -ftree-vecto
   -o "..\Frontend\public\wasm\atari_go_9x9.js" ^
   -s WASM=1 ^
   -s DISABLE_EXCEPTION_CATCHING=1 ^
-  -s EXPORTED_FUNCTIONS="['_getBestMove', _checkCapture, _wasMoveSuicidal]" ^
+  -s EXPORTED_FUNCTIONS="['_getBestMove', _ponder, _getTopMoves, _checkCapture, _wasMoveSuicidal]" ^
   -s EXPORTED_RUNTIME_METHODS="['ccall', 'cwrap', 'lengthBytesUTF8']" ^
   -s ALLOW_MEMORY_GROWTH=1 ^
+  -s INITIAL_MEMORY=67108864 ^
   -s ENVIRONMENT="web,worker" ^
   -s MALLOC="emmalloc" ^
   -s ASSERTIONS=0 ^
@@ -42,9 +43,10 @@ call em++ -std=c++17 -O3 -flto -ffast-math -msimd128 -funroll-loops -ftree-vecto
   -o "..\Frontend\public\wasm\atari_go_8x8.js" ^
   -s WASM=1 ^
   -s DISABLE_EXCEPTION_CATCHING=1 ^
-  -s EXPORTED_FUNCTIONS="['_getBestMove', _checkCapture, _wasMoveSuicidal]" ^
+  -s EXPORTED_FUNCTIONS="['_getBestMove', _ponder, _getTopMoves, _checkCapture, _wasMoveSuicidal]" ^
   -s EXPORTED_RUNTIME_METHODS="['ccall', 'cwrap', 'lengthBytesUTF8']" ^
   -s ALLOW_MEMORY_GROWTH=1 ^
+  -s INITIAL_MEMORY=67108864 ^
   -s ENVIRONMENT="web,worker" ^
   -s MALLOC="emmalloc" ^
   -s ASSERTIONS=0 ^
@@ -69,9 +71,10 @@ call em++ -std=c++17 -O3 -flto -ffast-math -msimd128 -funroll-loops -ftree-vecto
   -o "..\Frontend\public\wasm\atari_go_7x7.js" ^
   -s WASM=1 ^
   -s DISABLE_EXCEPTION_CATCHING=1 ^
-  -s EXPORTED_FUNCTIONS="['_getBestMove', _checkCapture, _wasMoveSuicidal]" ^
+  -s EXPORTED_FUNCTIONS="['_getBestMove', _ponder, _getTopMoves, _checkCapture, _wasMoveSuicidal]" ^
   -s EXPORTED_RUNTIME_METHODS="['ccall', 'cwrap', 'lengthBytesUTF8']" ^
   -s ALLOW_MEMORY_GROWTH=1 ^
+  -s INITIAL_MEMORY=67108864 ^
   -s ENVIRONMENT="web,worker" ^
   -s MALLOC="emmalloc" ^
   -s ASSERTIONS=0 ^
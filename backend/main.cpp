@@ -1,23 +1,33 @@
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
+#include <string>
 #include <chrono>
+#include <thread>
 
 #include "Board.h"
 #include "AtariGo.h"
 #include "Globals.h"
 #include "MiniMax.cpp"
+#include "MonteCarlo.h"
 
 class Game {
 public:
-    static void run() {
-        Board board;
+    static void run(const SearchOptions &options, const MonteCarloOptions &mctsOptions, const bool ponder,
+                    const bool useMonteCarlo) {
+        Board board = openingPosition();
         AtariGo atariGo;
 
-        board.setStone(3, 5);
-        board.setStone(3, 4);
-        board.setStone(4, 4);
-        board.setStone(4, 5);
-        AtariGo::computeHeuristic(board);
+        // One engine for the whole game, so each search starts from the TT (or tree) left by the previous one
+        MiniMax minimax(options);
+        std::unique_ptr<MonteCarlo> monteCarlo;
+        if (useMonteCarlo) monteCarlo = std::make_unique<MonteCarlo>(mctsOptions);
+        constexpr auto timeLimit = std::chrono::milliseconds(5000);
+        constexpr int depthLimit = 64;
+
+        // Pondering: while the human thinks, the engine searches the position after the reply it expects
+        std::unique_ptr<SearchHandle> ponderSearch;
+        Board ponderPosition;
 
         constexpr Player human = BLACK;
         constexpr Player computer = WHITE;
@@ -32,19 +42,41 @@ public:
             if (AtariGo::isTerminal(board)) {
                 std::cout << "Game over. Terminal state reached.\n";
                 std::cout << (board.getHeuristic() > 0 ? "WHITE" : "BLACK") << " wins!\n";
+                ponderSearch.reset();
                 break;
             }
 
             if (turn == human) {
+                if (ponder && !monteCarlo) {
+                    if (const int reply = minimax.expectedReply(board); reply != NO_MOVE) {
+                        std::cout << "Pondering on (" << reply / BOARD_EDGE << ", " << reply % BOARD_EDGE << ")\n";
+                        ponderPosition = board;
+                        ponderPosition.setStone(reply);
+                        AtariGo::computeHeuristic(ponderPosition);
+                        ponderSearch = minimax.startSearch(ponderPosition, timeLimit, depthLimit, true);
+                    }
+                }
                 humanMove(board);
                 turn = computer;
             }
             else {
-                MiniMax minimax;
                 std::cout << "Player " << (turn == BLACK ? "BLACK" : "WHITE") << " (AI) is thinking...\n";
                 auto t0 = std::chrono::high_resolution_clock::now();
 
-                Board best = minimax.getBestMove(board, std::chrono::milliseconds(5000), 64);
+                Board best;
+                if (monteCarlo) {
+                    best = monteCarlo->getBestMove(board, timeLimit);
+                } else if (ponderSearch && ponderPosition.getSignature() == board.getSignature()) {
+                    // Ponder hit: the running search becomes the real one, and the time it already spent counts
+                    std::cout << "Ponder hit.\n";
+                    ponderSearch->ponderHit();
+                    best = ponderSearch->get();
+                } else {
+                    // Ponder miss: drop that search, its TT entries still help the new one
+                    ponderSearch.reset();
+                    best = minimax.getBestMove(board, timeLimit, depthLimit);
+                }
+                ponderSearch.reset();
 
                 auto t1 = std::chrono::high_resolution_clock::now();
                 auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
@@ -60,7 +92,99 @@ public:
         }
     }
 
+    /// Plays `games` games between MonteCarlo and MiniMax with `timeLimit` per move, alternating colors, and prints
+    /// the score.
+    static void match(const SearchOptions &options, const MonteCarloOptions &mctsOptions, const int games,
+                      const std::chrono::milliseconds timeLimit) {
+        MiniMax minimax(options);
+        MonteCarlo monteCarlo(mctsOptions);
+        int monteCarloWins = 0;
+        for (int game = 0; game < games; ++game) {
+            const Player monteCarloColor = game % 2 == 0 ? BLACK : WHITE;
+            minimax.clearTranspositionTable();
+            Board board = openingPosition();
+            while (!AtariGo::isTerminal(board)) {
+                board = board.getPlayerToMove() == monteCarloColor
+                            ? monteCarlo.getBestMove(board, timeLimit)
+                            : minimax.getBestMove(board, timeLimit, 64);
+            }
+            AtariGo::print(board);
+            const Player winner = board.getHeuristic() > 0 ? WHITE : BLACK;
+            if (winner == monteCarloColor) ++monteCarloWins;
+            std::cout << "Game " << game + 1 << ": " << (winner == monteCarloColor ? "MCTS" : "MiniMax") << " wins as "
+                    << (winner == BLACK ? "BLACK" : "WHITE") << ". MCTS " << monteCarloWins << " - "
+                    << game + 1 - monteCarloWins << " MiniMax\n";
+        }
+    }
+
+    /// Benchmark: plays `playouts` random games from the opening position with each playout policy and prints the
+    /// throughput and the win statistics.
+    static void benchmarkPlayouts(const uint64_t playouts) {
+        Board board = openingPosition();
+        Playout::Random random(getRandom()());
+        for (const Playout::Policy policy: {Playout::UNIFORM, Playout::LIGHT}) {
+            const auto start = std::chrono::steady_clock::now();
+            const Playout::Stats stats = Playout::evaluate(board, playouts, policy, random);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << (policy == Playout::UNIFORM ? "Uniform" : "Light") << " playouts: "
+                    << static_cast<uint64_t>(static_cast<double>(playouts) / seconds) << " per second, "
+                    << static_cast<double>(stats.moves) / static_cast<double>(playouts) << " moves each. BLACK wins "
+                    << 100 * stats.winRate(BLACK) << "%.\n";
+        }
+    }
+
+    /// Analysis: runs the df-pn solver on the opening position, or on the empty board with `emptyBoard`, for up to
+    /// `timeLimit` and prints what it proved.
+    static void solve(const SearchOptions &options, const std::chrono::milliseconds timeLimit, const bool emptyBoard) {
+        Board board = emptyBoard ? Board() : openingPosition();
+        AtariGo::computeHeuristic(board);
+        AtariGo::print(board);
+
+        const MiniMax minimax(options);
+        const auto start = std::chrono::steady_clock::now();
+        int move;
+        const DfpnSolver::Outcome outcome = minimax.solve(board, UINT64_MAX, timeLimit, move);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        const char *mover = board.getPlayerToMove() == BLACK ? "BLACK" : "WHITE";
+        switch (outcome) {
+            case DfpnSolver::MOVER_WINS:
+                std::cout << mover << " to move wins";
+                if (move != NO_MOVE) std::cout << " with (" << move / BOARD_EDGE << ", " << move % BOARD_EDGE << ")";
+                break;
+            case DfpnSolver::MOVER_LOSES: std::cout << mover << " to move loses"; break;
+            default: std::cout << "Unsolved"; break;
+        }
+        std::cout << " after " << minimax.getSolverNodeCount() << " nodes in " << elapsed << " ms.\n";
+    }
+
+    /// Analysis: prints the `lineCount` best moves of the opening position, searched for up to `timeLimit`.
+    static void analyse(const SearchOptions &options, const int lineCount, const std::chrono::milliseconds timeLimit) {
+        Board board = openingPosition();
+        AtariGo::print(board);
+
+        const MiniMax minimax(options);
+        const std::vector<RootLine> lines = minimax.getTopMoves(board, timeLimit, 64, lineCount);
+        for (size_t k = 0; k < lines.size(); ++k) {
+            std::cout << k + 1 << ". (" << lines[k].move / BOARD_EDGE << ", " << lines[k].move % BOARD_EDGE << ") "
+                    << lines[k].score << " at depth " << lines[k].depth << ":";
+            for (const int move: lines[k].pv) std::cout << " (" << move / BOARD_EDGE << ", " << move % BOARD_EDGE << ")";
+            std::cout << "\n";
+        }
+    }
+
 private:
+    static Board openingPosition() {
+        Board board;
+        board.setStone(3, 5);
+        board.setStone(3, 4);
+        board.setStone(4, 4);
+        board.setStone(4, 5);
+        AtariGo::computeHeuristic(board);
+        return board;
+    }
+
     static void humanMove(Board& board) {
         int row = -1, col = -1;
         bool validMove = false;
@@ -108,8 +232,98 @@ private:
     }
 };
 
-int main() {
-    Game::run();
+int main(int argc, char *argv[]) {
+    SearchOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    MonteCarloOptions mctsOptions;
+    mctsOptions.threads = options.threads;
+
+    bool ponder = true;
+    int solveMs = 0;
+    bool solveEmptyBoard = false;
+    int analyseLines = 0;
+    int analyseMs = 0;
+    bool useMonteCarlo = false;
+    int matchGames = 0;
+    int matchMs = 0;
+    uint64_t benchmarkPlayoutCount = 0;
+
+    // Usage: atari_go [--threads N] [--pvs] [--no-aspiration] [--no-time-management] [--no-quiescence] [--no-ladders] [--lambda-order N] [--dfpn-nodes N] [--no-lmr] [--lmr BASE DIVISOR] [--probcut THRESHOLD] [--no-etc] [--mtdf] [--no-extensions] [--no-ponder] [--solve MS] [--empty-board] [--analyse LINES MS] [--mcts] [--no-rave] [--match GAMES MS] [--bench-playouts N]
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+            mctsOptions.threads = options.threads;
+        } else if (arg == "--pvs") {
+            options.principalVariationSearch = true;
+        } else if (arg == "--no-aspiration") {
+            options.aspirationWindows = false;
+        } else if (arg == "--no-time-management") {
+            options.timeManagement = false;
+        } else if (arg == "--no-quiescence") {
+            options.quiescence = false;
+        } else if (arg == "--no-ladders") {
+            options.ladders = false;
+        } else if (arg == "--lambda-order" && i + 1 < argc) {
+            options.lambdaOrder = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--dfpn-nodes" && i + 1 < argc) {
+            options.dfpnNodeBudget = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--no-lmr") {
+            options.lateMoveReductions = false;
+        } else if (arg == "--lmr" && i + 2 < argc) {
+            options.lmrBase = std::atof(argv[++i]);
+            options.lmrDivisor = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--probcut" && i + 1 < argc) {
+            options.probCut = true;
+            options.probCutThreshold = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--no-etc") {
+            options.enhancedTranspositionCutoffs = false;
+        } else if (arg == "--mtdf") {
+            options.mtdf = true;
+        } else if (arg == "--no-extensions") {
+            options.atariExtensions = false;
+        } else if (arg == "--no-ponder") {
+            ponder = false;
+        } else if (arg == "--solve" && i + 1 < argc) {
+            solveMs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--empty-board") {
+            solveEmptyBoard = true;
+        } else if (arg == "--analyse" && i + 2 < argc) {
+            analyseLines = std::max(1, std::atoi(argv[++i]));
+            analyseMs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--mcts") {
+            useMonteCarlo = true;
+        } else if (arg == "--no-rave") {
+            mctsOptions.raveEquivalence = 0;
+        } else if (arg == "--bench-playouts" && i + 1 < argc) {
+            benchmarkPlayoutCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--match" && i + 2 < argc) {
+            matchGames = std::max(1, std::atoi(argv[++i]));
+            matchMs = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (benchmarkPlayoutCount) {
+        Game::benchmarkPlayouts(benchmarkPlayoutCount);
+        return 0;
+    }
+    if (solveMs) {
+        Game::solve(options, std::chrono::milliseconds(solveMs), solveEmptyBoard);
+        return 0;
+    }
+    if (analyseLines) {
+        Game::analyse(options, analyseLines, std::chrono::milliseconds(analyseMs));
+        return 0;
+    }
+    std::cout << "Searching with " << options.threads << " thread(s).\n";
+    if (matchGames) {
+        Game::match(options, mctsOptions, matchGames, std::chrono::milliseconds(matchMs));
+        return 0;
+    }
+
+    Game::run(options, mctsOptions, ponder, useMonteCarlo);
     return 0;
 }
 
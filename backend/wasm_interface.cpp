@@ -12,7 +12,7 @@ struct BoardParseResult {
     int maxDepth;
 };
 
-BoardParseResult parseBoard(const char* boardStr) {
+BoardParseResult parseBoard(const char* boardStr, const bool log = true) {
     BoardParseResult result;
     result.timeLimit = 3000; // Default time limit in ms
     result.maxDepth = 64; // Default max depth
@@ -61,6 +61,7 @@ BoardParseResult parseBoard(const char* boardStr) {
         else if (c == 'w') result.board.setWhite(i);
     }
     AtariGo::computeHeuristic(result.board);
+    if (!log) return result;
 
     std::cout << "Parsed time limit: " << result.timeLimit << "ms\n";
     std::cout << "Parsed max depth: " << result.maxDepth << "\n";
@@ -71,6 +72,27 @@ BoardParseResult parseBoard(const char* boardStr) {
     return result;
 }
 
+// Lives as long as the module, so its transposition table carries over from one move to the next
+MiniMax& getEngine() {
+    static MiniMax engine;
+    return engine;
+}
+
+// The worker is single-threaded, so it ponders in short slices between messages (see ponder below). Each slice warms
+// the transposition table for the position after the expected reply and adds to the time spent on it.
+struct PonderState {
+    uint64_t parentSignature = 0; // Position the expected reply was read for, 0 if none
+    int reply = NO_MOVE; // Read once: the slices fill the table and may age or evict the entry it came from
+    uint64_t signature = 0; // Position pondered on, 0 if none
+    int spentMs = 0;
+    MiniMax::PonderSession session; // The search the slices resume
+};
+
+PonderState& getPonderState() {
+    static PonderState state;
+    return state;
+}
+
 std::string boardToString(const Board& board) {
     std::string result;
     result.reserve(BOARD_SIZE);
@@ -90,10 +112,17 @@ extern "C" {
         std::cout << "getBestMove called with board: " << boardStr << "\n";
         auto [board, timeLimit, maxDepth] = parseBoard(boardStr);
 
-        MiniMax minimax;
+        // Ponder hit: the time spent pondering counts against the budget. Part of it is kept so the search can walk
+        // back up to the depth the pondering reached, which the warm transposition table makes quick.
+        PonderState &ponder = getPonderState();
+        if (ponder.signature == board.getSignature()) {
+            std::cout << "Ponder hit after " << ponder.spentMs << "ms.\n";
+            timeLimit = std::max(timeLimit / 4, timeLimit - ponder.spentMs);
+        }
+        ponder = {};
 
         std::cout << "Calling minimax with time limit of " << timeLimit << "ms...\n";
-        const Board bestMove = minimax.getBestMove(board, std::chrono::milliseconds(timeLimit), maxDepth);
+        const Board bestMove = getEngine().getBestMove(board, std::chrono::milliseconds(timeLimit), maxDepth);
         std::cout << "Minimax returned.\n";
 
         std::string result = boardToString(bestMove);
@@ -108,6 +137,58 @@ extern "C" {
         return ret;
     }
 
+    /// Ponders for about `sliceMs` on the reply expected after `boardStr` ("board;time;depth", the position right after
+    /// the engine's move). Returns 1 while more pondering can help, 0 once the search finished or there is no expected
+    /// reply. The worker calls it in a loop, yielding between calls so that the human's move is handled promptly.
+    EMSCRIPTEN_KEEPALIVE
+    int ponder(const char* boardStr, const int sliceMs) {
+        auto [board, timeLimit, maxDepth] = parseBoard(boardStr, false);
+        if (AtariGo::isTerminal(board)) return 0;
+
+        PonderState &ponder = getPonderState();
+        if (ponder.parentSignature != board.getSignature()) {
+            ponder = {};
+            ponder.parentSignature = board.getSignature();
+            ponder.reply = getEngine().expectedReply(board);
+        }
+        if (ponder.reply == NO_MOVE) return 0;
+        board.setStone(ponder.reply);
+        AtariGo::computeHeuristic(board);
+        ponder.signature = board.getSignature();
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool more = getEngine().ponderSlice(board, std::chrono::milliseconds(sliceMs), maxDepth, ponder.session);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        ponder.spentMs += static_cast<int>(elapsed);
+
+        return more ? 1 : 0;
+    }
+
+    /// Analysis for the review mode: the `lineCount` best moves of `boardStr` ("board;time;depth") from one search, as
+    /// "move,score,pv;" per line, best first. The pv is space-separated and starts with the move.
+    EMSCRIPTEN_KEEPALIVE
+    const char* getTopMoves(const char* boardStr, const int lineCount) {
+        std::cout << "getTopMoves called with board: " << boardStr << "\n";
+        auto [board, timeLimit, maxDepth] = parseBoard(boardStr);
+        getPonderState() = {};
+
+        const std::vector<RootLine> lines = getEngine().getTopMoves(
+            board, std::chrono::milliseconds(timeLimit), maxDepth, lineCount);
+
+        std::string result;
+        for (const RootLine &line: lines) {
+            result += std::to_string(line.move) + "," + std::to_string(line.score) + ",";
+            for (size_t k = 0; k < line.pv.size(); ++k) result += (k ? " " : "") + std::to_string(line.pv[k]);
+            result += ";";
+        }
+        std::cout << "Top moves: " << result << "\n";
+
+        const auto ret = new char[result.size() + 1];
+        std::strcpy(ret, result.c_str());
+        return ret;
+    }
+
     EMSCRIPTEN_KEEPALIVE
     const char* checkCapture(const char* boardStr) {
         std::cout << "Checking capturing with board: " << boardStr << "\n";
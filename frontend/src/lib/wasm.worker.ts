@@ -2,6 +2,23 @@ let wasmModule: any = null;
 
 const WASM_BASE_PATH = "/atari-go/wasm/";
 
+// Pondering: while the player thinks, search the reply the engine expects, in short slices so messages keep flowing
+const PONDER_SLICE_MS = 50;
+let ponderId = 0;
+
+const startPondering = (payload: string) => {
+  const id = ++ponderId;
+  const ponderSlice = () => {
+    if (id !== ponderId || !wasmModule?.ponder) return;
+    if (wasmModule.ponder(payload, PONDER_SLICE_MS)) setTimeout(ponderSlice, 0);
+  };
+  setTimeout(ponderSlice, 0);
+};
+
+const stopPondering = () => {
+  ponderId++;
+};
+
 self.onmessage = async (event) => {
   const { type, payload } = event.data;
 
@@ -24,6 +41,10 @@ self.onmessage = async (event) => {
         onRuntimeInitialized: () => {
           wasmModule = {
             getBestMove: (self as any).Module.cwrap("getBestMove", "string", ["string"]),
+            // Builds of the engine from before pondering do not export it
+            ponder: (self as any).Module._ponder
+              ? (self as any).Module.cwrap("ponder", "number", ["string", "number"])
+              : null,
             checkCapture: (self as any).Module.cwrap("checkCapture", "string", ["string"]),
             wasMoveSuicidal: (self as any).Module.cwrap("wasMoveSuicidal", "string", ["string"]),
           };
@@ -68,8 +89,14 @@ self.onmessage = async (event) => {
     }
 
     try {
+      stopPondering();
       const result = wasmModule.getBestMove(payload);
       self.postMessage({ type: "moveDone", payload: result });
+
+      // Ponder on the position after the engine's move, with the same time and depth limits
+      const [resultBoard] = result.split(";");
+      const limits = payload.substring(payload.indexOf(";"));
+      startPondering(`${resultBoard}${limits}`);
     } catch (error: unknown) {
       const errorMessage = error instanceof Error ? error.message : String(error);
       self.postMessage({ type: "error", payload: errorMessage });